@@ -0,0 +1,298 @@
+#include "Batch.hpp"
+#include "CandidateStore.hpp"
+#include "GameEngine.hpp"
+#include "GameIO.hpp"
+#include "Strategy.hpp"
+#include "OpeningBook.hpp"
+#include "DecisionTree.hpp"
+#include "Profile.hpp"
+#include "QuestionCache.hpp"
+#include "Random.hpp"
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Outcome of one headless game.
+struct GameRecord {
+    bool solved = false;
+    int questions = 0;
+    double latencyMicros = 0;
+};
+
+// Games per chunk handed to the pool; small enough to balance, large enough to amortise the queue lock.
+constexpr size_t kChunkGames = 32;
+// Games per chunk for lockstep modes, which advance a whole chunk together; the sample is ordered by
+// length, so a chunk mostly shares a few buckets.
+constexpr size_t kLockstepGames = 128;
+
+// One game of a lockstep chunk. Held by pointer: the oracle's stream and the coroutine's references pin it.
+struct LockstepGame {
+    LockstepGame(const CandidateStore& store, const StrategyInfo& mode, std::string_view word, GameState& reusedState,
+                 GameLog* gameLog, size_t index)
+        : secretWord(word), state(reusedState), strategy(mode.create(store, secretWord.length())),
+          oracle(secretWord, gameLog, index, mode.name),
+          task(gameLoop(*strategy, mode.rules, secretWord, state, oracle.out())) {}
+
+    std::string secretWord;
+    GameState& state;
+    std::unique_ptr<Strategy> strategy;
+    OracleIO oracle;
+    GameTask task;
+    int turn = 0;
+    std::chrono::steady_clock::duration elapsed{};
+    std::chrono::steady_clock::duration deciding{}; // spent on the question not yet asked, for the log
+};
+
+/**
+ * Function to play a chunk of games in lockstep.
+ * Every turn, all games stop before picking their question; the ones whose
+ * strategy needs letter counts are grouped by (length, asked letters,
+ * pattern), which fixes the candidate set, and each distinct state is
+ * counted once, all states of one length in a single pass over the bucket.
+ * Then every game picks its question and the oracle answers it.
+ * @param first Index of the chunk's first game in words.
+ * @param count Number of games in the chunk.
+ */
+void playLockstep(const StrategyInfo& mode, const CandidateStore& store, const std::vector<size_t>& words, size_t first,
+                  size_t count, GameLog& gameLog, std::vector<GameRecord>& records) {
+    using Clock = std::chrono::steady_clock;
+
+    // The worker's game states are kept from chunk to chunk, so their memory is only allocated once
+    thread_local std::vector<std::unique_ptr<GameState>> states;
+    std::vector<std::unique_ptr<LockstepGame>> games;
+    games.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string_view word = store.dictionary().word(words[first + i]);
+        if (i == states.size()) {
+            states.push_back(std::make_unique<GameState>(store, word.length()));
+        } else {
+            states[i]->reset(store, word.length());
+        }
+        games.push_back(std::make_unique<LockstepGame>(store, mode, word, *states[i], &gameLog, first + i));
+        LockstepGame& game = *games.back();
+        // Lockstep modes draw no random numbers, so their games are logged with seed 0
+        if (mode.rules.logAnswers) game.oracle.log(gameStartRecord(word, 0, store.dictionary().fingerprint()));
+        auto start = Clock::now();
+        game.task.pauseBeforeQuestions();
+        game.task.start();
+        game.elapsed += Clock::now() - start;
+        game.deciding = game.elapsed;
+    }
+
+    std::vector<LockstepGame*> needing;
+    std::vector<const CandidateSet*> sets;
+    std::vector<uint32_t> skips;
+    std::vector<LetterHistogram> counts;
+    std::vector<size_t> owner; // for each game in needing, its distinct state in sets
+    size_t active = count;
+    while (active > 0) {
+        // Shared step: one count per distinct state, one bucket pass per length
+        auto countStart = Clock::now();
+        needing.clear();
+        for (auto& game : games) {
+            if (game->task.choosing() && game->strategy->needsLetterCounts(game->state)) needing.push_back(game.get());
+        }
+        std::sort(needing.begin(), needing.end(), [](const LockstepGame* a, const LockstepGame* b) {
+            const GameState& x = a->state;
+            const GameState& y = b->state;
+            if (x.pattern().length() != y.pattern().length()) return x.pattern().length() < y.pattern().length();
+            if (x.guessedLetters() != y.guessedLetters()) return x.guessedLetters() < y.guessedLetters();
+            return x.pattern() < y.pattern();
+        });
+        sets.clear();
+        skips.clear();
+        owner.clear();
+        for (size_t i = 0; i < needing.size(); ++i) {
+            const GameState& state = needing[i]->state;
+            const GameState* previous = i > 0 ? &needing[i - 1]->state : nullptr;
+            if (!previous || previous->guessedLetters() != state.guessedLetters() || previous->pattern() != state.pattern()) {
+                sets.push_back(&state.candidates());
+                skips.push_back(state.guessedLetters());
+            }
+            owner.push_back(sets.size() - 1);
+        }
+        counts.resize(sets.size());
+        CandidateSet::letterCountsBatch(sets.data(), skips.data(), sets.size(), counts.data());
+        for (size_t i = 0; i < needing.size(); ++i) needing[i]->state.setLetterCounts(counts[owner[i]]);
+        auto countShare = needing.empty() ? Clock::duration{} : (Clock::now() - countStart) / static_cast<long>(needing.size());
+
+        // Per-game step: pick the question, answer it, and run up to the next pause
+        for (auto& game : games) {
+            if (game->task.finished()) continue;
+            auto start = Clock::now();
+            if (game->task.choosing()) {
+                if (game->state.hasLetterCounts()) {
+                    game->elapsed += countShare;
+                    game->deciding += countShare;
+                }
+                game->task.proceed();
+            }
+            if (!game->task.finished()) {
+                const Question& question = game->task.question();
+                auto askedAt = Clock::now();
+                game->deciding += askedAt - start;
+                std::string response = game->oracle.ask(question);
+                ++game->turn;
+                auto answeredAt = Clock::now();
+                if (mode.rules.logAnswers) {
+                    game->oracle.log(questionRecord(question, response, game->turn, answeredAt - askedAt, game->deciding));
+                }
+                game->task.resume(std::move(response));
+                game->deciding = Clock::now() - answeredAt;
+            }
+            game->elapsed += Clock::now() - start;
+            if (game->task.finished()) {
+                --active;
+                if (mode.rules.logAnswers) game->oracle.log(gameEndRecord(game->task.result().won, game->turn));
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        GameRecord& record = records[first + i];
+        record.solved = games[i]->task.result().won;
+        record.questions = games[i]->oracle.questionsAsked();
+        record.latencyMicros = std::chrono::duration<double, std::micro>(games[i]->elapsed).count();
+    }
+}
+
+// Value at the given percentile of an unsorted sample (the sample is reordered).
+template <typename T>
+T percentile(std::vector<T>& sample, double fraction) {
+    if (sample.empty()) return T();
+    size_t rank = std::min(sample.size() - 1, static_cast<size_t>(fraction * sample.size()));
+    std::nth_element(sample.begin(), sample.begin() + rank, sample.end());
+    return sample[rank];
+}
+
+} // namespace
+
+/**
+ * Function to run every selected strategy headless over the dictionary.
+ * @param dictionary The loaded dictionary.
+ * @param options Which strategies and how many words to play.
+ * @param report The stream to print the results on.
+ * @return 0 on success, 1 if the strategy name is unknown or the log cannot be opened.
+ */
+int runBatch(const Dictionary& dictionary, const BatchOptions& options, std::ostream& report) {
+    CandidateStore store(dictionary);
+    OpeningBook book;
+    if (!options.openingBook.empty() && book.load(options.openingBook, dictionary)) {
+        store.setOpeningBook(&book);
+    }
+    DecisionTree tree;
+    if (!options.decisionTree.empty() && tree.open(options.decisionTree, dictionary)) {
+        store.setDecisionTree(&tree);
+    }
+
+    const std::vector<StrategyInfo>& strategies = strategyRegistry();
+    std::vector<const StrategyInfo*> selected;
+    for (const auto& strategy : strategies) {
+        if (options.strategy.empty() || options.strategy == strategy.name) {
+            selected.push_back(&strategy);
+        }
+    }
+    if (selected.empty()) {
+        report << "Unknown strategy: " << options.strategy << "\nAvailable strategies:";
+        for (const auto& strategy : strategies) report << " " << strategy.name;
+        report << "\n";
+        return 1;
+    }
+
+    // Evenly spaced sample so every length bucket is represented
+    size_t games = (options.limit == 0 || options.limit > dictionary.size()) ? dictionary.size() : options.limit;
+    std::vector<size_t> words(games);
+    for (size_t i = 0; i < games; ++i) {
+        words[i] = i * dictionary.size() / games;
+    }
+
+    GameLog gameLog;
+    if (!options.logFile.empty() && !gameLog.open(options.logFile, options.logFormat)) {
+        return 1;
+    }
+
+    WorkStealingPool pool(options.threads);
+    report << "Playing " << games << " words per strategy on " << pool.size() << " thread(s), seed " << options.seed
+           << (store.openingBook() ? ", with opening book" : "") << (store.decisionTree() ? ", with decision tree" : "") << "\n";
+    report << std::left << std::setw(20) << "strategy" << std::right
+           << std::setw(8) << "games" << std::setw(10) << "win %"
+           << std::setw(10) << "mean q" << std::setw(8) << "p99 q"
+           << std::setw(12) << "mean us" << std::setw(12) << "p99 us"
+           << std::setw(12) << "games/s" << std::setw(10) << "cache %" << "\n";
+
+    std::vector<GameRecord> records(games);
+    for (const StrategyInfo* strategy : selected) {
+        uint64_t strategySeed = mixSeed(options.seed ^ (static_cast<uint64_t>(strategy - strategies.data()) << 48));
+        StrategyInfo mode = *strategy;
+        mode.rules.logAnswers = gameLog.isOpen(); // with --log every mode logs; without it none do
+
+        // A fresh cache per strategy, so its timings do not depend on which strategies ran before
+        std::unique_ptr<QuestionCache> cache;
+        if (options.cacheEntries > 0) cache = std::make_unique<QuestionCache>(options.cacheEntries);
+        store.setQuestionCache(cache.get());
+
+        ProfileStats profileBefore = profileTotals();
+        auto runStart = std::chrono::steady_clock::now();
+        bool lockstep = options.lockstep && mode.rules.lockstep && mode.create;
+        pool.parallelFor(games, lockstep ? kLockstepGames : kChunkGames, [&](size_t begin, size_t end, unsigned) {
+            if (lockstep) {
+                playLockstep(mode, store, words, begin, end - begin, gameLog, records);
+                return;
+            }
+            for (size_t game = begin; game < end; ++game) {
+                size_t id = words[game];
+                std::string secretWord(dictionary.word(id));
+                OracleIO oracle(secretWord, &gameLog, game, mode.name);
+                seedGameRng(mixSeed(strategySeed ^ id));
+
+                auto start = std::chrono::steady_clock::now();
+                bool solved = mode.playHeadless(mode, secretWord, store, oracle);
+                auto elapsed = std::chrono::steady_clock::now() - start;
+
+                // Each game owns its slot, so workers never write the same record
+                records[game].solved = solved;
+                records[game].questions = oracle.questionsAsked();
+                records[game].latencyMicros = std::chrono::duration<double, std::micro>(elapsed).count();
+            }
+        });
+        double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+
+        size_t wins = 0;
+        double meanQuestions = 0, meanLatency = 0;
+        std::vector<int> questions;
+        std::vector<double> latencies;
+        questions.reserve(games);
+        latencies.reserve(games);
+        for (const GameRecord& record : records) {
+            wins += record.solved;
+            meanQuestions += record.questions;
+            meanLatency += record.latencyMicros;
+            questions.push_back(record.questions);
+            latencies.push_back(record.latencyMicros);
+        }
+        meanQuestions /= games ? games : 1;
+        meanLatency /= games ? games : 1;
+
+        report << std::left << std::setw(20) << strategy->name << std::right << std::fixed
+               << std::setw(8) << games
+               << std::setw(10) << std::setprecision(2) << (games ? 100.0 * wins / games : 0.0)
+               << std::setw(10) << std::setprecision(2) << meanQuestions
+               << std::setw(8) << percentile(questions, 0.99)
+               << std::setw(12) << std::setprecision(1) << meanLatency
+               << std::setw(12) << std::setprecision(1) << percentile(latencies, 0.99)
+               << std::setw(12) << std::setprecision(0) << (wallSeconds > 0 ? games / wallSeconds : 0.0);
+        QuestionCache::Stats cacheStats = cache ? cache->stats() : QuestionCache::Stats();
+        if (cacheStats.hits + cacheStats.misses > 0) {
+            report << std::setw(10) << std::setprecision(1) << 100.0 * cacheStats.hitRate() << "\n";
+        } else {
+            report << std::setw(10) << "-" << "\n";
+        }
+        printProfile(profileTotals() - profileBefore, report); // Only in profile builds
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include "Dictionary.hpp"
+#include "GameLog.hpp"
+#include "QuestionCache.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * Options for a headless batch run.
+ */
+struct BatchOptions {
+    std::string strategy; // play only this strategy; empty plays all of them
+    size_t limit = 0;     // play an evenly spaced sample of this many words; 0 plays every word
+    unsigned threads = 0; // worker threads; 0 uses one per hardware thread
+    uint64_t seed = 1;    // seeds the randomized modes; the same seed gives the same results
+    std::string openingBook; // opening book file to use if it matches the dictionary; empty for none
+    std::string decisionTree; // decision tree file to use if it matches the dictionary; empty for none
+    std::string logFile;     // log every question of every game here; empty for no log
+    LogFormat logFormat = LogFormat::Jsonl;
+    bool lockstep = true;    // advance games of lockstep modes together, sharing candidate scans
+    size_t cacheEntries = QuestionCache::kDefaultCapacity; // question cache size per strategy; 0 for none
+};
+
+/**
+ * Plays every selected dictionary word against every selected strategy,
+ * answering from the known secret word, and prints one report line per
+ * strategy: win rate, mean/p99 questions, per-game solve latency, throughput
+ * and the hit rate of the question cache, which every strategy starts empty.
+ * Games are spread over a work-stealing pool and every game gets its own
+ * seed derived from (seed, strategy, word), so the outcome does not depend
+ * on the thread count or on which worker played which word.
+ * @return 0 on success, 1 if the strategy name is unknown or the log cannot be opened.
+ */
+int runBatch(const Dictionary& dictionary, const BatchOptions& options, std::ostream& report);
+
+#endif // BATCH_HPP
@@ -0,0 +1,182 @@
+#include "CandidateStore.hpp"
+#include "Profile.hpp"
+
+/**
+ * Starts a candidate set containing every word of the given length.
+ * @param store The dictionary index.
+ * @param length The length of the secret word.
+ */
+CandidateSet::CandidateSet(const CandidateStore& store, size_t length) : bucket_(nullptr) {
+    reset(store, length);
+}
+
+void CandidateSet::reset(const CandidateStore& store, size_t length) {
+    bucket_ = store.bucket(length);
+    narrowed_ = false;
+    if (!bucket_) {
+        bits_.clear();
+        return;
+    }
+
+    bits_.assign(bucket_->blocks, ~uint64_t{0});
+    size_t tail = bucket_->count % 64;
+    if (tail != 0) {
+        bits_.back() = (uint64_t{1} << tail) - 1;
+    }
+}
+
+void CandidateSet::requireLetterAt(size_t position, char letter) {
+    if (!bucket_) return;
+    int slot = letterSlot(letter);
+    narrowed_ = true;
+    for (size_t b = 0; b < bits_.size(); ++b) {
+        if (bits_[b]) bits_[b] &= bucket_->positionBlock(position, slot, b);
+    }
+}
+
+void CandidateSet::excludeLetterAt(size_t position, char letter) {
+    if (!bucket_) return;
+    int slot = letterSlot(letter);
+    narrowed_ = true;
+    for (size_t b = 0; b < bits_.size(); ++b) {
+        if (bits_[b]) bits_[b] &= ~bucket_->positionBlock(position, slot, b);
+    }
+}
+
+/**
+ * Narrows the set to the words that fit the pattern after a question.
+ * Positions showing the letter must hold it; unrevealed positions must not.
+ * All positions are applied in one pass over the bitset, skipping empty blocks.
+ * Compact images have no position bitsets, so there the words are checked
+ * against their text (see LengthBucket::scanAnswer).
+ * @param letter The letter that was asked about.
+ * @param guessedWord The pattern after the answer was applied (e.g., "_p_l_").
+ * @param changes If not null, receives every block the answer changed.
+ */
+void CandidateSet::applyAnswer(char letter, std::string_view guessedWord, std::vector<BlockChange>* changes) {
+    if (!bucket_) return;
+    narrowed_ = true;
+
+    int slot = letterSlot(letter);
+    [[maybe_unused]] size_t examined = 0; // candidates looked at, for the profile
+    for (size_t b = 0; b < bits_.size(); ++b) {
+        uint64_t block = bits_[b];
+        if (block == 0) continue;
+        if constexpr (kProfiling) examined += __builtin_popcountll(block);
+
+        uint64_t narrowedBlock = block;
+        if (!bucket_->positionBits) {
+            narrowedBlock = bucket_->scanAnswer(b, block, letter, guessedWord);
+        } else {
+            for (size_t i = 0; i < guessedWord.length() && narrowedBlock; ++i) {
+                if (guessedWord[i] == letter) {
+                    narrowedBlock &= bucket_->positionMask(i, slot)[b];
+                } else if (guessedWord[i] == '_') {
+                    narrowedBlock &= ~bucket_->positionMask(i, slot)[b];
+                }
+            }
+        }
+
+        if (narrowedBlock != block) {
+            if (changes) changes->push_back(BlockChange{static_cast<uint32_t>(b), block, narrowedBlock});
+            bits_[b] = narrowedBlock;
+        }
+    }
+    PROFILE_COUNT(WordsFiltered, examined);
+}
+
+void CandidateSet::undoChanges(const BlockChange* begin, const BlockChange* end, bool narrowed) {
+    // Newest first, in case a block was recorded more than once
+    while (end != begin) {
+        --end;
+        bits_[end->block] = end->before;
+    }
+    narrowed_ = narrowed;
+}
+
+void CandidateSet::redoChanges(const BlockChange* begin, const BlockChange* end) {
+    for (; begin != end; ++begin) {
+        bits_[begin->block] = begin->after;
+    }
+    narrowed_ = true;
+}
+
+size_t CandidateSet::count() const {
+    size_t total = 0;
+    for (uint64_t block : bits_) {
+        total += __builtin_popcountll(block);
+    }
+    return total;
+}
+
+bool CandidateSet::empty() const {
+    for (uint64_t block : bits_) {
+        if (block) return false;
+    }
+    return true;
+}
+
+/**
+ * Counts the remaining words containing each letter.
+ * Before the first answer the set is the whole bucket, whose counts were
+ * precomputed when the dictionary image was built.
+ * @param skipLetters Bit i set means letter 'a' + i is reported as zero.
+ */
+LetterHistogram CandidateSet::letterCounts(uint32_t skipLetters) const {
+    LetterHistogram counts{};
+    if (!bucket_) return counts;
+
+    if (!narrowed_) {
+        for (int letter = 0; letter < kAlphabetSize; ++letter) {
+            counts[letter] = (skipLetters & (uint32_t{1} << letter)) ? 0 : bucket_->letterCounts[letter];
+        }
+        return counts;
+    }
+
+    PROFILE_SCOPE(Frequency);
+    PROFILE_COUNT(WordsCounted, bucket_->count);
+    countLetters(bits_.data(), *bucket_, skipLetters, counts);
+    return counts;
+}
+
+/**
+ * Counts the remaining words containing each letter for many sets.
+ * Untouched sets use the precomputed bucket counts; each run of narrowed sets
+ * over the same bucket is counted in one countLettersBatch pass.
+ * @param sets The candidate sets, grouped by length.
+ * @param skipLetters One skip mask per set.
+ * @param count Number of sets.
+ * @param counts Receives one histogram per set.
+ */
+void CandidateSet::letterCountsBatch(const CandidateSet* const* sets, const uint32_t* skipLetters, size_t count,
+                                     LetterHistogram* counts) {
+    // Reused across calls, so lockstep turns do not allocate
+    thread_local std::vector<const uint64_t*> bits;
+    thread_local std::vector<uint32_t> skips;
+    thread_local std::vector<size_t> slots;
+    thread_local std::vector<LetterHistogram> batch;
+
+    size_t i = 0;
+    while (i < count) {
+        const LengthBucket* bucket = sets[i]->bucket_;
+        bits.clear();
+        skips.clear();
+        slots.clear();
+        for (; i < count && sets[i]->bucket_ == bucket; ++i) {
+            if (!bucket || !sets[i]->narrowed_) {
+                counts[i] = sets[i]->letterCounts(skipLetters[i]);
+                continue;
+            }
+            bits.push_back(sets[i]->bits_.data());
+            skips.push_back(skipLetters[i]);
+            slots.push_back(i);
+        }
+        if (slots.empty()) continue;
+
+        PROFILE_SCOPE(Frequency);
+        PROFILE_COUNT(WordsCounted, bucket->count * slots.size());
+        batch.resize(slots.size());
+        countLettersBatch(bits.data(), skips.data(), slots.size(), *bucket, batch.data());
+        for (size_t j = 0; j < slots.size(); ++j) counts[slots[j]] = batch[j];
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef CANDIDATE_STORE_HPP
+#define CANDIDATE_STORE_HPP
+
+#include "Dictionary.hpp"
+#include "LetterHistogram.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class DecisionTree;
+class OpeningBook;
+class QuestionCache;
+
+/**
+ * Length-bucketed index used to narrow candidate sets.
+ * Words are bucketed by length, and every bucket keeps one bitset per
+ * (position, letter) pair plus one per letter ("contains this letter anywhere"),
+ * so candidate sets can be narrowed with AND/ANDNOT instead of string scans.
+ * The buckets live in the dictionary image; the dictionary must outlive the store.
+ */
+class CandidateStore {
+public:
+    using Bucket = LengthBucket;
+
+    explicit CandidateStore(const Dictionary& dictionary) : dictionary_(dictionary) {}
+
+    // Returns the bucket for the given word length, or nullptr if no word has that length.
+    const Bucket* bucket(size_t length) const { return dictionary_.bucket(length); }
+    const Dictionary& dictionary() const { return dictionary_; }
+
+    // Optional precomputed opening moves for this dictionary (may be nullptr).
+    const OpeningBook* openingBook() const { return openingBook_; }
+    void setOpeningBook(const OpeningBook* book) { openingBook_ = book; }
+    // Optional compiled policy for this dictionary (may be nullptr); takes precedence over the book.
+    const DecisionTree* decisionTree() const { return decisionTree_; }
+    void setDecisionTree(const DecisionTree* tree) { decisionTree_ = tree; }
+    // Optional memo of letters chosen in states games reached before (may be nullptr); shared by every game.
+    QuestionCache* questionCache() const { return questionCache_; }
+    void setQuestionCache(QuestionCache* cache) { questionCache_ = cache; }
+
+private:
+    const Dictionary& dictionary_;
+    const OpeningBook* openingBook_ = nullptr;
+    const DecisionTree* decisionTree_ = nullptr;
+    QuestionCache* questionCache_ = nullptr;
+};
+
+/**
+ * The set of dictionary words still consistent with a game, stored as a
+ * bitset over one length bucket of a CandidateStore.
+ */
+class CandidateSet {
+public:
+    // One 64-word block of the bitset before and after an answer narrowed it.
+    struct BlockChange {
+        uint32_t block;
+        uint64_t before;
+        uint64_t after;
+    };
+
+    CandidateSet(const CandidateStore& store, size_t length);
+
+    // Starts over with every word of the given length, reusing the bitset's memory.
+    void reset(const CandidateStore& store, size_t length);
+
+    // Keeps only the words that have the letter at the given position.
+    void requireLetterAt(size_t position, char letter);
+    // Drops the words that have the letter at the given position.
+    void excludeLetterAt(size_t position, char letter);
+    // Narrows the set after a question about a letter, given the pattern it produced.
+    // Every block that changes is appended to changes when it is given.
+    void applyAnswer(char letter, std::string_view guessedWord, std::vector<BlockChange>* changes = nullptr);
+    // Puts back the "before" (undo) or "after" (redo) values of recorded changes.
+    void undoChanges(const BlockChange* begin, const BlockChange* end, bool narrowed);
+    void redoChanges(const BlockChange* begin, const BlockChange* end);
+
+    bool narrowed() const { return narrowed_; }
+
+    size_t count() const;
+    bool empty() const;
+
+    // Number of remaining words containing each letter; letters in skipLetters count as zero.
+    LetterHistogram letterCounts(uint32_t skipLetters = 0) const;
+    // letterCounts for many sets at once; sets of the same length share one pass over their bucket
+    // (see countLettersBatch), so pass them grouped by length.
+    static void letterCountsBatch(const CandidateSet* const* sets, const uint32_t* skipLetters, size_t count,
+                                  LetterHistogram* counts);
+
+    // Calls fn(std::string_view) for each remaining word, in dictionary order.
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t b = 0; b < bits_.size(); ++b) {
+            uint64_t block = bits_[b];
+            while (block) {
+                fn(bucket_->word(b * 64 + __builtin_ctzll(block)));
+                block &= block - 1;
+            }
+        }
+    }
+
+private:
+    const CandidateStore::Bucket* bucket_;
+    std::vector<uint64_t> bits_;
+    bool narrowed_ = false; // false while the set is still the whole bucket
+};
+
+#endif // CANDIDATE_STORE_HPP
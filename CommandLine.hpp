@@ -0,0 +1,62 @@
+#ifndef COMMAND_LINE_HPP
+#define COMMAND_LINE_HPP
+
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+
+/**
+ * Function to read a command-line flag's numeric value.
+ * @param flag The flag, for the error message.
+ * @param text The value as given.
+ * @param value Receives the number; left untouched if the text is not one.
+ * @return True if text is a whole number that fits, false (after saying so) otherwise.
+ */
+template <typename Number>
+bool parseNumber(const std::string& flag, const char* text, Number& value) {
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long number = std::strtoull(text, &end, 10);
+    if (*text < '0' || *text > '9' || *end != '\0' || errno == ERANGE || number > std::numeric_limits<Number>::max()) {
+        std::cerr << "Invalid value for " << flag << ": " << text << "\n";
+        return false;
+    }
+    value = static_cast<Number>(number);
+    return true;
+}
+
+// The same for a decimal value, such as a time in seconds.
+inline bool parseNumber(const std::string& flag, const char* text, double& value) {
+    char* end = nullptr;
+    errno = 0;
+    double number = std::strtod(text, &end);
+    if (end == text || *end != '\0' || errno == ERANGE || !std::isfinite(number)) {
+        std::cerr << "Invalid value for " << flag << ": " << text << "\n";
+        return false;
+    }
+    value = number;
+    return true;
+}
+
+/**
+ * Function to read a server address: a Unix-domain socket path or "tcp:PORT".
+ * @param address The address as given.
+ * @param port Receives the TCP port, or 0 for a socket path.
+ * @return True if the address is a path or has a port from 1 to 65535, false (after saying so) otherwise.
+ */
+inline bool parseAddress(const std::string& address, uint16_t& port) {
+    port = 0;
+    if (address.compare(0, 4, "tcp:") != 0) return true;
+    if (!parseNumber("tcp:PORT", address.c_str() + 4, port)) return false;
+    if (port == 0) {
+        std::cerr << "Invalid value for tcp:PORT: 0 (use 1 to 65535)\n";
+        return false;
+    }
+    return true;
+}
+
+#endif // COMMAND_LINE_HPP
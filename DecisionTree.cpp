@@ -0,0 +1,396 @@
+#include "DecisionTree.hpp"
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kTreeMagic[8] = {'K', 'N', 'O', 'W', 'T', 'R', 'E', 'E'};
+constexpr uint32_t kTreeVersion = 1;
+constexpr uint32_t kNoRoot = UINT32_MAX;
+
+// Levels built on the calling thread; every subtree below them is one pool task.
+constexpr int kSplitDepth = 2;
+
+// On-disk layout. Offsets are in bytes from the start of the image and every
+// section starts on an 8-byte boundary, as in the dictionary index.
+struct TreeHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t rootCount;     // one past the longest word length covered
+    uint64_t fingerprint;   // Dictionary::fingerprint() of the dictionary it was built from
+    uint64_t nodeCount;
+    uint64_t edgeCount;
+    uint64_t rootsOffset;    // uint32_t[rootCount]
+    uint64_t nodesOffset;    // Node[nodeCount]
+    uint64_t positionsOffset; // uint64_t[edgeCount]
+    uint64_t childrenOffset; // uint32_t[edgeCount]
+    uint64_t totalBytes;
+};
+
+size_t alignUp(size_t bytes) {
+    return (bytes + 7) & ~size_t{7};
+}
+
+// Nodes and edges of one part of the tree while it is being built.
+template <typename Node>
+struct Part {
+    std::vector<Node> nodes;
+    std::vector<uint64_t> positions;
+    std::vector<uint32_t> children;
+};
+
+// A subtree left for the pool: the answers leading to it and the edge that points at it.
+struct Task {
+    size_t length;
+    std::vector<LetterAnswer> path;
+    uint32_t edge;
+};
+
+// Every distinct set of positions the letter occupies among the candidates, sorted.
+std::vector<uint64_t> answersFor(const CandidateSet& candidates, char letter) {
+    std::vector<uint64_t> answers;
+    candidates.forEach([&](std::string_view word) {
+        uint64_t positions = 0;
+        for (size_t i = 0; i < word.length(); ++i) {
+            if (word[i] == letter) positions |= uint64_t{1} << i;
+        }
+        answers.push_back(positions);
+    });
+    std::sort(answers.begin(), answers.end());
+    answers.erase(std::unique(answers.begin(), answers.end()), answers.end());
+    return answers;
+}
+
+/**
+ * Adds the node for a state and, below it, every answer's subtree.
+ * Answers are applied to the shared state and undone afterwards, as in the
+ * opening book. Below splitDepth levels the subtrees become tasks instead.
+ * @return The node's index in part, or kNoRoot if the part grew too large.
+ */
+template <typename Node>
+uint32_t expand(GameState& state, Part<Node>& part, int splitDepth, std::vector<LetterAnswer>& path, std::vector<Task>* tasks) {
+    if (part.nodes.size() >= kNoRoot || part.positions.size() >= kNoRoot) return kNoRoot;
+    uint32_t index = static_cast<uint32_t>(part.nodes.size());
+    part.nodes.push_back(Node{0, 0, '\0', 0});
+    if (state.solved()) return index;
+
+    const CandidateSet& candidates = state.candidates();
+    char letter = mostFrequentLetter(candidates.letterCounts(state.guessedLetters()));
+    if (letter == '\0') return index;
+
+    std::vector<uint64_t> answers = answersFor(candidates, letter);
+    if (answers.size() > UINT16_MAX) return kNoRoot;
+    uint32_t firstEdge = static_cast<uint32_t>(part.positions.size());
+    part.nodes[index] = Node{firstEdge, static_cast<uint16_t>(answers.size()), letter, 0};
+    part.positions.insert(part.positions.end(), answers.begin(), answers.end());
+    part.children.resize(part.positions.size(), kNoRoot);
+
+    for (size_t i = 0; i < answers.size(); ++i) {
+        LetterAnswer answer{letter, answers[i]};
+        if (tasks && splitDepth <= 1) {
+            path.push_back(answer);
+            tasks->push_back(Task{state.pattern().length(), path, firstEdge + static_cast<uint32_t>(i)});
+            path.pop_back();
+            continue;
+        }
+        state.apply(answer);
+        path.push_back(answer);
+        uint32_t child = expand(state, part, splitDepth - 1, path, tasks);
+        path.pop_back();
+        state.undo();
+        if (child == kNoRoot) return kNoRoot;
+        part.children[firstEdge + i] = child;
+    }
+    return index;
+}
+
+} // namespace
+
+DecisionTree::~DecisionTree() {
+    release();
+}
+
+DecisionTree::DecisionTree(DecisionTree&& other) noexcept {
+    *this = std::move(other);
+}
+
+DecisionTree& DecisionTree::operator=(DecisionTree&& other) noexcept {
+    if (this != &other) {
+        release();
+        owned_ = std::move(other.owned_);
+        mapping_ = other.mapping_;
+        mappingBytes_ = other.mappingBytes_;
+        rootCount_ = other.rootCount_;
+        nodeCount_ = other.nodeCount_;
+        edgeCount_ = other.edgeCount_;
+        roots_ = other.roots_;
+        nodes_ = other.nodes_;
+        positions_ = other.positions_;
+        children_ = other.children_;
+        other.mapping_ = nullptr;
+        other.mappingBytes_ = 0;
+        other.rootCount_ = other.nodeCount_ = other.edgeCount_ = 0;
+        other.roots_ = nullptr;
+        other.nodes_ = nullptr;
+        other.positions_ = nullptr;
+        other.children_ = nullptr;
+    }
+    return *this;
+}
+
+void DecisionTree::release() {
+    if (mapping_) {
+        munmap(mapping_, mappingBytes_);
+        mapping_ = nullptr;
+        mappingBytes_ = 0;
+    }
+    owned_.clear();
+    rootCount_ = nodeCount_ = edgeCount_ = 0;
+    roots_ = nullptr;
+    nodes_ = nullptr;
+    positions_ = nullptr;
+    children_ = nullptr;
+}
+
+/**
+ * Function to compile the decision tree.
+ * The top kSplitDepth levels of every length are built here; each subtree
+ * below them is built by the pool into its own arrays, which are then
+ * appended with their indices shifted.
+ * @param store The dictionary index.
+ * @param threads Worker threads; 0 uses one per hardware thread.
+ * @return The tree, or an empty tree if it does not fit the format.
+ */
+DecisionTree DecisionTree::build(const CandidateStore& store, unsigned threads) {
+    DecisionTree tree;
+    size_t rootCount = std::min<size_t>(store.dictionary().bucketCount(), 65);
+
+    Part<Node> top;
+    std::vector<Task> tasks;
+    std::vector<uint32_t> roots(rootCount, kNoRoot);
+    for (size_t length = 1; length < rootCount; ++length) {
+        if (!store.bucket(length)) continue;
+        GameState state(store, length);
+        std::vector<LetterAnswer> path;
+        roots[length] = expand(state, top, kSplitDepth, path, &tasks);
+        if (roots[length] == kNoRoot) {
+            std::cerr << "Error: Decision tree is too large for the tree format.\n";
+            return tree;
+        }
+    }
+
+    std::vector<Part<Node>> parts(tasks.size());
+    std::vector<uint32_t> partRoots(tasks.size(), kNoRoot);
+    WorkStealingPool pool(threads);
+    pool.parallelFor(tasks.size(), 1, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            GameState state(store, tasks[i].length);
+            for (const LetterAnswer& answer : tasks[i].path) state.apply(answer);
+            std::vector<LetterAnswer> path;
+            partRoots[i] = expand(state, parts[i], 0, path, static_cast<std::vector<Task>*>(nullptr));
+        }
+    });
+
+    // Append every part after the top levels, shifting its node and edge indices
+    size_t nodeCount = top.nodes.size(), edgeCount = top.positions.size();
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (partRoots[i] == kNoRoot) {
+            std::cerr << "Error: Decision tree is too large for the tree format.\n";
+            return tree;
+        }
+        nodeCount += parts[i].nodes.size();
+        edgeCount += parts[i].positions.size();
+    }
+    if (nodeCount >= kNoRoot || edgeCount >= kNoRoot) {
+        std::cerr << "Error: Decision tree is too large for the tree format.\n";
+        return tree;
+    }
+
+    TreeHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kTreeMagic, sizeof(kTreeMagic));
+    header.version = kTreeVersion;
+    header.rootCount = static_cast<uint32_t>(rootCount);
+    header.fingerprint = store.dictionary().fingerprint();
+    header.nodeCount = nodeCount;
+    header.edgeCount = edgeCount;
+    header.rootsOffset = alignUp(sizeof(TreeHeader));
+    header.nodesOffset = alignUp(header.rootsOffset + rootCount * sizeof(uint32_t));
+    header.positionsOffset = alignUp(header.nodesOffset + nodeCount * sizeof(Node));
+    header.childrenOffset = alignUp(header.positionsOffset + edgeCount * sizeof(uint64_t));
+    header.totalBytes = alignUp(header.childrenOffset + edgeCount * sizeof(uint32_t));
+
+    tree.owned_.assign(header.totalBytes / sizeof(uint64_t), 0);
+    char* base = reinterpret_cast<char*>(tree.owned_.data());
+    std::memcpy(base, &header, sizeof(header));
+    std::memcpy(base + header.rootsOffset, roots.data(), rootCount * sizeof(uint32_t));
+    Node* nodes = reinterpret_cast<Node*>(base + header.nodesOffset);
+    uint64_t* positions = reinterpret_cast<uint64_t*>(base + header.positionsOffset);
+    uint32_t* children = reinterpret_cast<uint32_t*>(base + header.childrenOffset);
+
+    std::copy(top.nodes.begin(), top.nodes.end(), nodes);
+    std::copy(top.positions.begin(), top.positions.end(), positions);
+    std::copy(top.children.begin(), top.children.end(), children);
+    uint32_t nodeOffset = static_cast<uint32_t>(top.nodes.size());
+    uint32_t edgeOffset = static_cast<uint32_t>(top.positions.size());
+    for (size_t i = 0; i < parts.size(); ++i) {
+        const Part<Node>& part = parts[i];
+        for (size_t n = 0; n < part.nodes.size(); ++n) {
+            nodes[nodeOffset + n] = part.nodes[n];
+            nodes[nodeOffset + n].firstEdge += edgeOffset;
+        }
+        for (size_t e = 0; e < part.positions.size(); ++e) {
+            positions[edgeOffset + e] = part.positions[e];
+            children[edgeOffset + e] = part.children[e] + nodeOffset;
+        }
+        children[tasks[i].edge] = partRoots[i] + nodeOffset;
+        nodeOffset += static_cast<uint32_t>(part.nodes.size());
+        edgeOffset += static_cast<uint32_t>(part.positions.size());
+    }
+
+    tree.attach(tree.owned_.data(), header.totalBytes, "(built in memory)", header.fingerprint);
+    return tree;
+}
+
+/**
+ * Function to save the decision tree.
+ * @param filename The name of the tree file (normally next to the dictionary).
+ * @param dictionary The dictionary the tree was built from.
+ * @return True if the file was written successfully, false otherwise.
+ */
+bool DecisionTree::save(const std::string& filename, const Dictionary& dictionary) const {
+    if (owned_.empty()) return false;
+    TreeHeader header;
+    std::memcpy(&header, owned_.data(), sizeof(header));
+    if (header.fingerprint != dictionary.fingerprint()) return false;
+
+    // Written beside the old file and renamed over it: a running game may have the old one mapped
+    std::string temporary = filename + ".tmp";
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not write decision tree: " << filename << "\n";
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(owned_.data()), static_cast<std::streamsize>(header.totalBytes));
+    file.close();
+    if (!file || std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Function to map a decision tree file.
+ * @param filename The name of the tree file.
+ * @param dictionary The dictionary the game is using.
+ * @return True if the tree was mapped and matches the dictionary, false otherwise.
+ */
+bool DecisionTree::open(const std::string& filename, const Dictionary& dictionary) {
+    release();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false; // The tree is optional
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(TreeHeader))) {
+        std::cerr << "Error: Decision tree is truncated: " << filename << "\n";
+        ::close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "Error: Could not map decision tree: " << filename << "\n";
+        return false;
+    }
+
+    mapping_ = data;
+    mappingBytes_ = info.st_size;
+    if (!attach(data, mappingBytes_, filename, dictionary.fingerprint())) {
+        release();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Points the tree at an image after checking its header and section bounds.
+ * Node and edge indices are checked on use, so this runs in constant time.
+ */
+bool DecisionTree::attach(const void* data, size_t bytes, const std::string& filename, uint64_t fingerprint) {
+    const char* base = static_cast<const char*>(data);
+    TreeHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    auto fits = [bytes](uint64_t offset, uint64_t count, uint64_t size) {
+        return offset <= bytes && count <= (bytes - offset) / size && offset % 8 == 0;
+    };
+
+    if (std::memcmp(header.magic, kTreeMagic, sizeof(kTreeMagic)) != 0 || header.version != kTreeVersion) {
+        std::cerr << "Error: Not a Knowsall decision tree (or wrong version): " << filename << "\n";
+        return false;
+    }
+    if (header.fingerprint != fingerprint) {
+        std::cerr << "Note: " << filename << " was built for a different dictionary; ignoring it.\n";
+        return false;
+    }
+    if (header.totalBytes > bytes ||
+        !fits(header.rootsOffset, header.rootCount, sizeof(uint32_t)) ||
+        !fits(header.nodesOffset, header.nodeCount, sizeof(Node)) ||
+        !fits(header.positionsOffset, header.edgeCount, sizeof(uint64_t)) ||
+        !fits(header.childrenOffset, header.edgeCount, sizeof(uint32_t))) {
+        std::cerr << "Error: Decision tree is corrupt: " << filename << "\n";
+        return false;
+    }
+
+    rootCount_ = header.rootCount;
+    nodeCount_ = header.nodeCount;
+    edgeCount_ = header.edgeCount;
+    roots_ = reinterpret_cast<const uint32_t*>(base + header.rootsOffset);
+    nodes_ = reinterpret_cast<const Node*>(base + header.nodesOffset);
+    positions_ = reinterpret_cast<const uint64_t*>(base + header.positionsOffset);
+    children_ = reinterpret_cast<const uint32_t*>(base + header.childrenOffset);
+    return true;
+}
+
+bool DecisionTree::lookup(std::string_view guessedWord, uint32_t guessedLetters, char& letter) const {
+    if (guessedWord.length() >= rootCount_ || roots_[guessedWord.length()] >= nodeCount_) return false;
+
+    uint32_t index = roots_[guessedWord.length()];
+    while (true) {
+        const Node& node = nodes_[index];
+        int slot = letterSlot(node.letter);
+        // The first letter not asked yet is the question; asked ones lead down their answer's edge
+        if (node.letter == '\0' || slot == kAlphabetSize || !(guessedLetters & (uint32_t{1} << slot))) {
+            letter = node.letter;
+            return true;
+        }
+
+        uint64_t positions = 0;
+        for (size_t i = 0; i < guessedWord.length(); ++i) {
+            if (guessedWord[i] == node.letter) positions |= uint64_t{1} << i;
+        }
+        if (node.firstEdge > edgeCount_ || node.edgeCount > edgeCount_ - node.firstEdge) return false;
+        const uint64_t* begin = positions_ + node.firstEdge;
+        const uint64_t* end = begin + node.edgeCount;
+        const uint64_t* edge = std::lower_bound(begin, end, positions);
+        if (edge == end || *edge != positions) {
+            letter = '\0'; // No dictionary word gives this answer
+            return true;
+        }
+        index = children_[edge - positions_];
+        if (index >= nodeCount_) return false;
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef DECISION_TREE_HPP
+#define DECISION_TREE_HPP
+
+#include "CandidateStore.hpp"
+#include "GameState.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * The whole most-frequent-letter policy, compiled.
+ * For a fixed dictionary the policy's question depends only on the answers so
+ * far, so every game of one length is a walk down one tree: each node holds
+ * the letter asked and one edge per answer the dictionary can give (the set
+ * of positions the letter occupies). The tree is stored as flat node and edge
+ * arrays in a file next to the dictionary and mapped as-is, like the index;
+ * playing from it needs no filtering or counting at all.
+ */
+class DecisionTree {
+public:
+    DecisionTree() = default;
+    ~DecisionTree();
+    DecisionTree(const DecisionTree&) = delete;
+    DecisionTree& operator=(const DecisionTree&) = delete;
+    DecisionTree(DecisionTree&& other) noexcept;
+    DecisionTree& operator=(DecisionTree&& other) noexcept;
+
+    // Builds the tree for every length bucket on a work-stealing pool (threads 0: one per core).
+    static DecisionTree build(const CandidateStore& store, unsigned threads = 0);
+
+    bool save(const std::string& filename, const Dictionary& dictionary) const;
+    // Maps a tree file; fails if it was built for different dictionary contents.
+    bool open(const std::string& filename, const Dictionary& dictionary);
+
+    /**
+     * Finds the policy's letter for a state by following its answers from the root.
+     * @param letter Receives the letter, or '\0' when no candidate is left to ask about.
+     * @return False if the tree does not cover words of this length.
+     */
+    bool lookup(std::string_view guessedWord, uint32_t guessedLetters, char& letter) const;
+
+    bool empty() const { return nodeCount_ == 0; }
+    size_t nodes() const { return nodeCount_; }
+    size_t edges() const { return edgeCount_; }
+
+private:
+    struct Node {
+        uint32_t firstEdge;
+        uint16_t edgeCount;
+        char letter; // '\0' for leaves
+        char reserved;
+    };
+
+    bool attach(const void* data, size_t bytes, const std::string& filename, uint64_t fingerprint);
+    void release();
+
+    std::vector<uint64_t> owned_; // backing storage when built in memory
+    void* mapping_ = nullptr;     // backing storage when mapped
+    size_t mappingBytes_ = 0;
+
+    size_t rootCount_ = 0;
+    size_t nodeCount_ = 0;
+    size_t edgeCount_ = 0;
+    const uint32_t* roots_ = nullptr;     // root node per word length; UINT32_MAX for none
+    const Node* nodes_ = nullptr;
+    const uint64_t* positions_ = nullptr; // per edge: the answer's positions, sorted within a node
+    const uint32_t* children_ = nullptr;  // per edge: the node it leads to
+};
+
+#endif // DECISION_TREE_HPP
@@ -0,0 +1,498 @@
+#include "Dictionary.hpp"
+#include <algorithm>
+#include <bit>
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kIndexMagic[8] = {'K', 'N', 'O', 'W', 'S', 'I', 'D', 'X'};
+constexpr uint32_t kIndexVersion = 3;
+constexpr uint64_t kCompactFlag = 1; // IndexHeader::flags: the buckets carry no position bitsets
+
+// On-disk layout. Every offset is in bytes from the start of the image and
+// every section starts on an 8-byte boundary so the bitsets can be used in place.
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t bucketCount;   // one past the longest word length
+    uint64_t wordCount;
+    uint64_t flags;         // kCompactFlag or 0
+    uint64_t blobOffset;    // all words back to back, grouped by length; a bucket's words are one run
+    uint64_t blobBytes;
+    uint64_t bucketsOffset; // IndexBucket[bucketCount]
+    uint64_t totalBytes;
+    uint64_t fingerprint;   // hash of the packed words and bucket sizes, see Dictionary::fingerprint
+};
+
+struct IndexBucket {
+    uint32_t wordCount;
+    uint32_t firstWord;
+    uint64_t positionBitsOffset; // length * kLetterSlots bitsets (none in compact images)
+    uint64_t letterBitsOffset;   // kAlphabetSize bitsets
+    uint32_t letterCounts[kAlphabetSize];
+};
+
+// Bytes kept readable after the last word, so the text scan can load 16 bytes of any word at once.
+constexpr size_t kTextSlack = 16;
+
+size_t alignUp(size_t bytes) {
+    return (bytes + 7) & ~size_t{7};
+}
+
+/**
+ * Finds a letter in a word of up to 16 characters, eight bytes at a time.
+ * Reads 16 bytes from word; the image keeps kTextSlack bytes after the text for that.
+ * @return Bit i set if word[i] is the letter (bits past the word's length are meaningless).
+ */
+uint64_t letterPositions16(const char* word, size_t length, char letter) {
+    constexpr uint64_t kLow7 = 0x7f7f7f7f7f7f7f7fULL;
+    constexpr uint64_t kGather = 0x0102040810204080ULL; // moves the low bit of byte i to bit 56 + i
+    uint64_t pattern = 0x0101010101010101ULL * static_cast<unsigned char>(letter);
+    uint64_t positions = 0;
+    for (size_t half = 0; half * 8 < length; ++half) {
+        uint64_t bytes;
+        std::memcpy(&bytes, word + half * 8, sizeof(bytes));
+        uint64_t x = bytes ^ pattern;
+        uint64_t zero = ~(((x & kLow7) + kLow7) | x | kLow7); // 0x80 in every byte that matched
+        positions |= (((zero >> 7) * kGather) >> 56) << (half * 8);
+    }
+    return positions;
+}
+
+/**
+ * Hashes the packed words of an image, eight bytes at a time, and the bucket
+ * sizes that split them into words. Editing a word, even just moving letters
+ * within it, changes the hash; the layout (full or compact) does not.
+ * @param blob The words, grouped by length.
+ * @param blobBytes The length of the words together.
+ * @param bucketSizes The number of words of each length.
+ * @return The fingerprint.
+ */
+uint64_t hashWords(const char* blob, size_t blobBytes, const std::vector<size_t>& bucketSizes) {
+    uint64_t hash = 0xcbf29ce484222325ULL; // FNV-1a over 64-bit units
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 0x100000001b3ULL;
+        hash ^= hash >> 29;
+    };
+    for (size_t size : bucketSizes) mix(size);
+    size_t i = 0;
+    for (; i + 8 <= blobBytes; i += 8) {
+        uint64_t bytes;
+        std::memcpy(&bytes, blob + i, sizeof(bytes));
+        mix(bytes);
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, blob + i, blobBytes - i);
+    mix(tail ^ (uint64_t{blobBytes - i} << 56));
+    return hash;
+}
+
+/**
+ * Lays out a dictionary image for the given words.
+ * @param words The words in source order.
+ * @param layout Whether to include the position bitsets.
+ * @param image Receives the image, in 64-bit units so the bitsets are aligned.
+ * @return True on success, false if the words do not fit the format.
+ */
+bool compileImage(const std::vector<std::string_view>& words, ImageLayout layout, std::vector<uint64_t>& image) {
+    size_t bucketCount = 0;
+    size_t blobBytes = 0;
+    for (const auto& word : words) {
+        bucketCount = std::max(bucketCount, word.length() + 1);
+        blobBytes += word.length();
+    }
+    if (words.size() >= UINT32_MAX) {
+        std::cerr << "Error: Dictionary is too large for the index format.\n";
+        return false;
+    }
+
+    // Group the words by length, keeping source order inside each group
+    std::vector<size_t> bucketSizes(bucketCount, 0);
+    for (const auto& word : words) {
+        ++bucketSizes[word.length()];
+    }
+    std::vector<size_t> bucketStart(bucketCount, 0);
+    for (size_t length = 1; length < bucketCount; ++length) {
+        bucketStart[length] = bucketStart[length - 1] + bucketSizes[length - 1];
+    }
+    std::vector<std::string_view> ordered(words.size());
+    std::vector<size_t> next = bucketStart;
+    for (const auto& word : words) {
+        ordered[next[word.length()]++] = word;
+    }
+
+    // Size every section
+    bool compact = layout == ImageLayout::Compact;
+    size_t offset = alignUp(sizeof(IndexHeader));
+    size_t blobOffset = offset;
+    offset = alignUp(offset + blobBytes + kTextSlack);
+    size_t bucketsOffset = offset;
+    offset = alignUp(offset + bucketCount * sizeof(IndexBucket));
+    std::vector<IndexBucket> buckets(bucketCount);
+    for (size_t length = 0; length < bucketCount; ++length) {
+        size_t blocks = (bucketSizes[length] + 63) / 64;
+        IndexBucket& bucket = buckets[length];
+        std::memset(&bucket, 0, sizeof(bucket));
+        bucket.wordCount = static_cast<uint32_t>(bucketSizes[length]);
+        bucket.firstWord = static_cast<uint32_t>(bucketStart[length]);
+        bucket.positionBitsOffset = offset;
+        if (!compact) offset += length * kLetterSlots * blocks * sizeof(uint64_t);
+        bucket.letterBitsOffset = offset;
+        offset += kAlphabetSize * blocks * sizeof(uint64_t);
+    }
+
+    image.assign(offset / sizeof(uint64_t), 0);
+    char* base = reinterpret_cast<char*>(image.data());
+
+    IndexHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kIndexMagic, sizeof(kIndexMagic));
+    header.version = kIndexVersion;
+    header.bucketCount = static_cast<uint32_t>(bucketCount);
+    header.wordCount = words.size();
+    header.flags = compact ? kCompactFlag : 0;
+    header.blobOffset = blobOffset;
+    header.blobBytes = blobBytes;
+    header.bucketsOffset = bucketsOffset;
+    header.totalBytes = offset;
+
+    // Words; every one in a bucket has the same length, so its place follows from its id
+    char* blob = base + blobOffset;
+    for (const auto& word : ordered) {
+        std::memcpy(blob, word.data(), word.length());
+        blob += word.length();
+    }
+    header.fingerprint = hashWords(base + blobOffset, blobBytes, bucketSizes);
+
+    // Bitsets and letter counts
+    for (size_t length = 0; length < bucketCount; ++length) {
+        IndexBucket& bucket = buckets[length];
+        size_t blocks = (bucket.wordCount + 63) / 64;
+        uint64_t* positionBits = reinterpret_cast<uint64_t*>(base + bucket.positionBitsOffset);
+        uint64_t* letterBits = reinterpret_cast<uint64_t*>(base + bucket.letterBitsOffset);
+
+        for (size_t i = 0; i < bucket.wordCount; ++i) {
+            std::string_view word = ordered[bucket.firstWord + i];
+            size_t block = i / 64;
+            uint64_t bit = uint64_t{1} << (i % 64);
+            uint32_t seen = 0;
+            for (size_t p = 0; p < length; ++p) {
+                int slot = letterSlot(word[p]);
+                if (!compact) positionBits[(p * kLetterSlots + slot) * blocks + block] |= bit;
+                if (slot < kAlphabetSize) {
+                    letterBits[slot * blocks + block] |= bit;
+                    seen |= uint32_t{1} << slot;
+                }
+            }
+            for (int letter = 0; letter < kAlphabetSize; ++letter) {
+                if (seen & (uint32_t{1} << letter)) ++bucket.letterCounts[letter];
+            }
+        }
+    }
+
+    std::memcpy(base, &header, sizeof(header));
+    std::memcpy(base + bucketsOffset, buckets.data(), bucketCount * sizeof(IndexBucket));
+    return true;
+}
+
+} // namespace
+
+Dictionary::~Dictionary() {
+    release();
+}
+
+Dictionary::Dictionary(Dictionary&& other) noexcept {
+    *this = std::move(other);
+}
+
+Dictionary& Dictionary::operator=(Dictionary&& other) noexcept {
+    if (this != &other) {
+        release();
+        owned_ = std::move(other.owned_);
+        mapping_ = other.mapping_;
+        mappingBytes_ = other.mappingBytes_;
+        wordCount_ = other.wordCount_;
+        fingerprint_ = other.fingerprint_;
+        layout_ = other.layout_;
+        buckets_ = std::move(other.buckets_);
+        lengths_ = std::move(other.lengths_);
+        other.mapping_ = nullptr;
+        other.mappingBytes_ = 0;
+        other.wordCount_ = 0;
+        other.fingerprint_ = 0;
+        other.buckets_.clear();
+        other.lengths_.clear();
+    }
+    return *this;
+}
+
+void Dictionary::release() {
+    if (mapping_) {
+        munmap(mapping_, mappingBytes_);
+        mapping_ = nullptr;
+        mappingBytes_ = 0;
+    }
+    owned_.clear();
+    wordCount_ = 0;
+    fingerprint_ = 0;
+    layout_ = ImageLayout::Full;
+    buckets_.clear();
+    lengths_.clear();
+}
+
+/**
+ * Function to map a compiled dictionary index.
+ * @param filename The name of the index file.
+ * @return True if the file was mapped and looks valid, false otherwise.
+ */
+bool Dictionary::openIndex(const std::string& filename) {
+    release();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open dictionary index: " << filename << "\n";
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(IndexHeader))) {
+        std::cerr << "Error: Dictionary index is truncated: " << filename << "\n";
+        ::close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "Error: Could not map dictionary index: " << filename << "\n";
+        return false;
+    }
+
+    mapping_ = data;
+    mappingBytes_ = info.st_size;
+    if (!attach(data, mappingBytes_, filename)) {
+        release();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Function to load a text dictionary and build its image in memory.
+ * @param filename The name of the dictionary file (one word per line).
+ * @param layout Full for the fastest filtering, Compact for the smallest image.
+ * @return True if the file was loaded successfully, false otherwise.
+ */
+bool Dictionary::loadText(const std::string& filename, ImageLayout layout) {
+    release();
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open dictionary file: " << filename << "\n";
+        return false;
+    }
+
+    // Read the whole file at once and split it in place
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::vector<std::string_view> words;
+    size_t start = 0;
+    while (start < contents.size()) {
+        size_t end = contents.find('\n', start);
+        if (end == std::string::npos) end = contents.size();
+        size_t length = end - start;
+        if (length > 0 && contents[start + length - 1] == '\r') --length;
+        if (length > 0) {
+            words.emplace_back(contents.data() + start, length);
+        }
+        start = end + 1;
+    }
+
+    if (!compileImage(words, layout, owned_)) {
+        owned_.clear();
+        return false;
+    }
+    return attach(owned_.data(), owned_.size() * sizeof(uint64_t), filename);
+}
+
+/**
+ * Function to save the dictionary image as a compiled index file.
+ * @param filename The name of the index file to write.
+ * @return True if the file was written successfully, false otherwise.
+ */
+bool Dictionary::writeIndex(const std::string& filename) const {
+    const char* data = mapping_ ? static_cast<const char*>(mapping_) : reinterpret_cast<const char*>(owned_.data());
+    size_t bytes = mapping_ ? mappingBytes_ : owned_.size() * sizeof(uint64_t);
+    if (!data || bytes == 0) return false;
+
+    // Written beside the old file and renamed over it: a running game may have the old one mapped
+    std::string temporary = filename + ".tmp";
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not write dictionary index: " << filename << "\n";
+        return false;
+    }
+    file.write(data, static_cast<std::streamsize>(bytes));
+    file.close();
+    if (!file || std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Points the dictionary at an image after checking its header and section bounds.
+ * Only the per-bucket tables are walked, so this does not depend on the word count.
+ */
+bool Dictionary::attach(const void* data, size_t bytes, const std::string& filename) {
+    const char* base = static_cast<const char*>(data);
+    IndexHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    auto fits = [bytes](uint64_t offset, uint64_t length) {
+        return offset <= bytes && length <= bytes - offset && offset % 8 == 0;
+    };
+
+    if (std::memcmp(header.magic, kIndexMagic, sizeof(kIndexMagic)) != 0 || header.version != kIndexVersion) {
+        std::cerr << "Error: Not a Knowsall dictionary index (or wrong version): " << filename << "\n";
+        return false;
+    }
+    if (header.totalBytes > bytes ||
+        !fits(header.blobOffset, header.blobBytes + kTextSlack) ||
+        !fits(header.bucketsOffset, uint64_t{header.bucketCount} * sizeof(IndexBucket))) {
+        std::cerr << "Error: Dictionary index is corrupt: " << filename << "\n";
+        return false;
+    }
+
+    wordCount_ = header.wordCount;
+    fingerprint_ = header.fingerprint;
+    layout_ = (header.flags & kCompactFlag) ? ImageLayout::Compact : ImageLayout::Full;
+    const char* blob = base + header.blobOffset;
+    uint64_t textOffset = 0;
+    uint64_t nextWord = 0; // buckets hold consecutive ids, shortest words first
+
+    const IndexBucket* buckets = reinterpret_cast<const IndexBucket*>(base + header.bucketsOffset);
+    buckets_.assign(header.bucketCount, LengthBucket());
+    for (size_t length = 0; length < header.bucketCount; ++length) {
+        const IndexBucket& source = buckets[length];
+        LengthBucket& bucket = buckets_[length];
+        bucket.length = length;
+        bucket.count = source.wordCount;
+        bucket.firstWord = source.firstWord;
+        bucket.blocks = (bucket.count + 63) / 64;
+        bucket.letterCounts = source.letterCounts;
+
+        uint64_t positionBytes = layout_ == ImageLayout::Full ? length * kLetterSlots * bucket.blocks * sizeof(uint64_t) : 0;
+        uint64_t letterBytes = kAlphabetSize * bucket.blocks * sizeof(uint64_t);
+        uint64_t textBytes = uint64_t{bucket.count} * length;
+        if (bucket.firstWord != nextWord || bucket.count > wordCount_ - nextWord ||
+            textBytes > header.blobBytes - textOffset ||
+            !fits(source.positionBitsOffset, positionBytes) ||
+            !fits(source.letterBitsOffset, letterBytes)) {
+            std::cerr << "Error: Dictionary index is corrupt: " << filename << "\n";
+            release();
+            return false;
+        }
+        bucket.text = blob + textOffset;
+        textOffset += textBytes;
+        nextWord += bucket.count;
+        bucket.positionBits = positionBytes ? reinterpret_cast<const uint64_t*>(base + source.positionBitsOffset) : nullptr;
+        bucket.letterBits = reinterpret_cast<const uint64_t*>(base + source.letterBitsOffset);
+        if (bucket.count) lengths_.push_back(length);
+    }
+    return true;
+}
+
+std::string_view Dictionary::word(size_t id) const {
+    // The last bucket starting at or before the id holds it; there are only a few dozen
+    auto it = std::upper_bound(lengths_.begin(), lengths_.end(), id,
+                               [this](size_t wordId, size_t length) { return wordId < buckets_[length].firstWord; });
+    const LengthBucket& bucket = buckets_[*(it - 1)];
+    return bucket.word(id - bucket.firstWord);
+}
+
+/**
+ * Builds one block of a position bitset from the words' text, for compact images.
+ * @param position The letter position.
+ * @param slot The letter's slot (see letterSlot).
+ * @param block Which 64 words.
+ * @return Bit i set if word block * 64 + i has the letter at the position.
+ */
+uint64_t LengthBucket::scanPosition(size_t position, int slot, size_t block) const {
+    uint64_t bits = 0;
+    size_t first = block * 64;
+    size_t words = count - first < 64 ? count - first : 64;
+    const char* at = text + first * length + position;
+    for (size_t i = 0; i < words; ++i, at += length) {
+        if (letterSlot(*at) == slot) bits |= uint64_t{1} << i;
+    }
+    return bits;
+}
+
+/**
+ * Narrows one block of candidates after an answer, for compact images.
+ * A miss only needs the letter bitset; after a hit, just the words that
+ * contain the letter are compared with the pattern.
+ * @param block Which 64 words.
+ * @param candidates The block's candidates before the answer.
+ * @param letter The letter that was asked about.
+ * @param guessedWord The pattern after the answer was applied.
+ * @return The candidates with the letter exactly where the pattern shows it.
+ */
+uint64_t LengthBucket::scanAnswer(size_t block, uint64_t candidates, char letter, std::string_view guessedWord) const {
+    int slot = letterSlot(letter);
+    if (slot < kAlphabetSize) {
+        bool hit = guessedWord.find(letter) != std::string_view::npos;
+        candidates &= hit ? letterMask(slot)[block] : ~letterMask(slot)[block];
+        if (!hit) return candidates;
+    }
+
+    uint64_t kept = candidates;
+    if (length > 64) {
+        for (uint64_t rest = candidates; rest; rest &= rest - 1) {
+            int bit = __builtin_ctzll(rest);
+            const char* word = text + (block * 64 + bit) * length;
+            for (size_t i = 0; i < length; ++i) {
+                bool here = letterSlot(word[i]) == slot;
+                if (guessedWord[i] == letter ? !here : (guessedWord[i] == '_' && here)) {
+                    kept &= ~(uint64_t{1} << bit);
+                    break;
+                }
+            }
+        }
+        return kept;
+    }
+
+    // As masks: a word fits if, of the positions the pattern says anything about, it has the letter at exactly the shown ones
+    uint64_t shown = 0, known = 0;
+    for (size_t i = 0; i < length; ++i) {
+        shown |= uint64_t{guessedWord[i] == letter} << i;
+        known |= uint64_t{guessedWord[i] == letter || guessedWord[i] == '_'} << i;
+    }
+    bool swar = std::endian::native == std::endian::little && slot < kAlphabetSize && length <= 16;
+    for (uint64_t rest = candidates; rest; rest &= rest - 1) {
+        int bit = __builtin_ctzll(rest);
+        const char* word = text + (block * 64 + bit) * length;
+        uint64_t has = 0;
+        if (swar) {
+            has = letterPositions16(word, length, letter);
+        } else {
+            for (size_t i = 0; i < length; ++i) has |= uint64_t{letterSlot(word[i]) == slot} << i;
+        }
+        if ((has & known) != shown) kept &= ~(uint64_t{1} << bit);
+    }
+    return kept;
+}
+
+const LengthBucket* Dictionary::bucket(size_t length) const {
+    if (length >= buckets_.size() || buckets_[length].count == 0) return nullptr;
+    return &buckets_[length];
+}
@@ -0,0 +1,120 @@
+#ifndef DICTIONARY_HPP
+#define DICTIONARY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Letters 'a'-'z' get their own slot; every other character shares the last one.
+constexpr int kAlphabetSize = 26;
+constexpr int kLetterSlots = kAlphabetSize + 1;
+
+/**
+ * Maps a character to its bitset slot.
+ * @param c The character to map.
+ * @return 0-25 for 'a'-'z', kAlphabetSize for anything else.
+ */
+inline int letterSlot(char c) {
+    return (c >= 'a' && c <= 'z') ? c - 'a' : kAlphabetSize;
+}
+
+/**
+ * How much of the filtering index a dictionary image carries.
+ * Full images hold a bitset per (position, letter) pair, so narrowing by a
+ * revealed letter is a few ANDs per 64 words. Compact images leave those out,
+ * which takes 27 bits per letter of every word and shrinks the image about
+ * 3.5 times for English word lengths; words that contain a revealed letter
+ * are then checked against their packed text instead.
+ */
+enum class ImageLayout { Full, Compact };
+
+/**
+ * All dictionary words of one length, viewed inside a dictionary image.
+ * Words are packed back to back (stride == length) and every bucket carries
+ * one bitset per letter ("contains this letter anywhere"), plus one per
+ * (position, letter) pair in full images.
+ */
+struct LengthBucket {
+    size_t length = 0;
+    size_t count = 0;                     // words in the bucket
+    size_t firstWord = 0;                 // dictionary id of the first word
+    size_t blocks = 0;                    // 64-bit words per bitset
+    const char* text = nullptr;           // count * length characters
+    const uint64_t* positionBits = nullptr; // [position][slot][block]; nullptr in compact images
+    const uint64_t* letterBits = nullptr;   // [letter][block]
+    const uint32_t* letterCounts = nullptr; // words containing each letter
+
+    std::string_view word(size_t i) const { return std::string_view(text + i * length, length); }
+    const uint64_t* positionMask(size_t position, int slot) const {
+        return positionBits + (position * kLetterSlots + slot) * blocks;
+    }
+    const uint64_t* letterMask(int letter) const {
+        return letterBits + static_cast<size_t>(letter) * blocks;
+    }
+
+    // One 64-bit block of the words with the slot's letter at the position, from either layout.
+    uint64_t positionBlock(size_t position, int slot, size_t block) const {
+        return positionBits ? positionMask(position, slot)[block] : scanPosition(position, slot, block);
+    }
+    uint64_t scanPosition(size_t position, int slot, size_t block) const;
+    // The candidates of one block that fit the pattern an answer about the letter produced, read from the text.
+    uint64_t scanAnswer(size_t block, uint64_t candidates, char letter, std::string_view guessedWord) const;
+};
+
+/**
+ * Read-only dictionary image.
+ * The image is either a compiled index file mapped straight into memory
+ * (see knowsall-index) or the same layout built in memory from a text file.
+ * Word ids are ordered by length, then by their order in the source file.
+ */
+class Dictionary {
+public:
+    Dictionary() = default;
+    ~Dictionary();
+    Dictionary(const Dictionary&) = delete;
+    Dictionary& operator=(const Dictionary&) = delete;
+    Dictionary(Dictionary&& other) noexcept;
+    Dictionary& operator=(Dictionary&& other) noexcept;
+
+    // Maps a compiled index file; runs in constant time regardless of its size.
+    bool openIndex(const std::string& filename);
+    // Reads a text dictionary (one word per line) and builds the image in memory.
+    bool loadText(const std::string& filename, ImageLayout layout = ImageLayout::Full);
+    // Writes the current image as a compiled index file.
+    bool writeIndex(const std::string& filename) const;
+
+    size_t size() const { return wordCount_; }
+    bool empty() const { return wordCount_ == 0; }
+    std::string_view word(size_t id) const;
+
+    ImageLayout layout() const { return layout_; }
+    // Size of the image in bytes, mapped or in memory.
+    size_t imageBytes() const { return mapping_ ? mappingBytes_ : owned_.size() * sizeof(uint64_t); }
+
+    // Content fingerprint (a hash of every word, taken when the image was built),
+    // used to tell whether files derived from the dictionary still match it.
+    uint64_t fingerprint() const { return fingerprint_; }
+
+    // One past the longest word length.
+    size_t bucketCount() const { return buckets_.size(); }
+    // Returns the bucket for the given length, or nullptr if no word has that length.
+    const LengthBucket* bucket(size_t length) const;
+
+private:
+    bool attach(const void* data, size_t bytes, const std::string& filename);
+    void release();
+
+    std::vector<uint64_t> owned_;   // backing storage when built in memory
+    void* mapping_ = nullptr;       // backing storage when mapped
+    size_t mappingBytes_ = 0;
+
+    size_t wordCount_ = 0;
+    uint64_t fingerprint_ = 0;
+    ImageLayout layout_ = ImageLayout::Full;
+    std::vector<LengthBucket> buckets_; // indexed by word length
+    std::vector<size_t> lengths_;       // lengths that have words, ascending, so also by first id
+};
+
+#endif // DICTIONARY_HPP
@@ -0,0 +1,176 @@
+#include "DictionarySnapshot.hpp"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Quiet time after the last change before reloading; knowsall-index writes three files in a row.
+constexpr int kSettleMs = 250;
+
+// The part of a path after its last '/'.
+std::string baseName(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+// The path without its extension (e.g., "dictionary" for "dictionary.txt").
+std::string stemOf(const std::string& path) {
+    size_t dot = path.rfind('.');
+    size_t slash = path.rfind('/');
+    return (dot == std::string::npos || (slash != std::string::npos && dot < slash)) ? path : path.substr(0, dot);
+}
+
+} // namespace
+
+/**
+ * Function to load the dictionary from a file.
+ * A compiled index next to the text file (e.g., dictionary.kdx) is mapped
+ * instead when it exists and is not older than the text file.
+ * @param filename The name of the dictionary file.
+ * @param dictionary The dictionary to load the words into.
+ * @return True if the file was loaded successfully, false otherwise.
+ */
+bool loadDictionary(const std::string& filename, Dictionary& dictionary) {
+    std::string indexName = stemOf(filename) + ".kdx";
+
+    struct stat textInfo, indexInfo;
+    if (stat(indexName.c_str(), &indexInfo) == 0) {
+        // Nanoseconds matter: a reload may see the text edited within the second the index was written
+        bool textNewer = stat(filename.c_str(), &textInfo) == 0 &&
+                         (textInfo.st_mtim.tv_sec != indexInfo.st_mtim.tv_sec ? textInfo.st_mtim.tv_sec > indexInfo.st_mtim.tv_sec
+                                                                              : textInfo.st_mtim.tv_nsec > indexInfo.st_mtim.tv_nsec);
+        if (textNewer) {
+            std::cerr << "Note: " << indexName << " is older than " << filename << "; loading the text file instead.\n";
+        } else if (dictionary.openIndex(indexName)) {
+            return true;
+        }
+    }
+
+    return dictionary.loadText(filename);
+}
+
+/**
+ * Function to build a snapshot from the dictionary files.
+ * The opening book and decision tree are optional and only used when they
+ * were built for exactly this dictionary.
+ * @param textFile The dictionary text file; the .kdx, .book and .tree files are looked for beside it.
+ * @param version The version number to give the snapshot.
+ * @return The snapshot, or nullptr if the dictionary could not be loaded or is empty.
+ */
+std::shared_ptr<const DictionarySnapshot> DictionarySnapshot::load(const std::string& textFile, uint64_t version) {
+    std::shared_ptr<DictionarySnapshot> snapshot(new DictionarySnapshot(version));
+    if (!loadDictionary(textFile, snapshot->dictionary_)) return nullptr;
+    if (snapshot->dictionary_.empty()) {
+        std::cerr << "Error: The dictionary is empty: " << textFile << "\n";
+        return nullptr;
+    }
+
+    snapshot->store_.setQuestionCache(&snapshot->cache_);
+    std::string stem = stemOf(textFile);
+    if (snapshot->book_.load(stem + ".book", snapshot->dictionary_)) {
+        snapshot->store_.setOpeningBook(&snapshot->book_);
+    }
+    if (snapshot->tree_.open(stem + ".tree", snapshot->dictionary_)) {
+        snapshot->store_.setDecisionTree(&snapshot->tree_);
+    }
+    snapshot->index_.emplace(snapshot->dictionary_);
+    return snapshot;
+}
+
+DictionaryWatcher::~DictionaryWatcher() {
+    if (thread_.joinable()) {
+        uint64_t one = 1;
+        if (write(stopFd_, &one, sizeof(one)) != static_cast<ssize_t>(sizeof(one))) {
+            std::cerr << "Warning: Could not stop the dictionary watcher: " << std::strerror(errno) << "\n";
+        }
+        thread_.join();
+    }
+    if (inotifyFd_ >= 0) close(inotifyFd_);
+    if (stopFd_ >= 0) close(stopFd_);
+}
+
+bool DictionaryWatcher::load() {
+    std::shared_ptr<const DictionarySnapshot> snapshot = DictionarySnapshot::load(textFile_, versions_ + 1);
+    if (!snapshot) return false;
+    ++versions_;
+    current_.store(std::move(snapshot), std::memory_order_release);
+    return true;
+}
+
+/**
+ * Function to start watching the dictionary files.
+ * The directory is watched rather than the files, so a file replaced by a
+ * rename (as editors and knowsall-index do) is still noticed.
+ * @return True if the watcher thread is running, false otherwise.
+ */
+bool DictionaryWatcher::watch() {
+    size_t slash = textFile_.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : textFile_.substr(0, slash == 0 ? 1 : slash);
+
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    stopFd_ = eventfd(0, EFD_CLOEXEC);
+    if (inotifyFd_ < 0 || stopFd_ < 0 || inotify_add_watch(inotifyFd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        std::cerr << "Error: Could not watch " << directory << " for dictionary changes: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    thread_ = std::thread([this]() { run(); });
+    return true;
+}
+
+/**
+ * Watcher thread: collects change events until they have been quiet for
+ * kSettleMs, then reloads once, until the destructor signals stopFd_.
+ */
+void DictionaryWatcher::run() {
+    std::string stem = baseName(stemOf(textFile_));
+    const std::string watched[] = {baseName(textFile_), stem + ".kdx", stem + ".book", stem + ".tree"};
+
+    pollfd fds[2] = {{inotifyFd_, POLLIN, 0}, {stopFd_, POLLIN, 0}};
+    bool pending = false;
+    while (true) {
+        int ready = poll(fds, 2, pending ? kSettleMs : -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Error: Dictionary watcher stopped: " << std::strerror(errno) << "\n";
+            return;
+        }
+        if (fds[1].revents) return;
+        if (ready == 0) {
+            pending = false;
+            reload();
+            continue;
+        }
+
+        alignas(inotify_event) char buffer[4096];
+        ssize_t bytes;
+        while ((bytes = read(inotifyFd_, buffer, sizeof(buffer))) > 0) {
+            for (char* at = buffer; at < buffer + bytes;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(at);
+                at += sizeof(inotify_event) + event->len;
+                if (event->len == 0) continue;
+                for (const std::string& name : watched) {
+                    if (name == event->name) pending = true;
+                }
+            }
+        }
+    }
+}
+
+// Builds and publishes the next version, keeping the current one if the files do not load.
+void DictionaryWatcher::reload() {
+    std::shared_ptr<const DictionarySnapshot> snapshot = DictionarySnapshot::load(textFile_, versions_ + 1);
+    if (!snapshot) {
+        std::cerr << "Warning: Could not reload " << textFile_ << "; keeping dictionary version " << versions_ << ".\n";
+        return;
+    }
+    ++versions_;
+    size_t words = snapshot->dictionary().size();
+    current_.store(std::move(snapshot), std::memory_order_release);
+    std::cerr << "Note: Reloaded " << textFile_ << " (dictionary version " << versions_ << ", " << words << " words).\n";
+}
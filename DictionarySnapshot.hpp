@@ -0,0 +1,90 @@
+#ifndef DICTIONARY_SNAPSHOT_HPP
+#define DICTIONARY_SNAPSHOT_HPP
+
+#include "CandidateStore.hpp"
+#include "DecisionTree.hpp"
+#include "Dictionary.hpp"
+#include "OpeningBook.hpp"
+#include "QuestionCache.hpp"
+#include "WordIndex.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+bool loadDictionary(const std::string& filename, Dictionary& dictionary);
+
+/**
+ * One version of the dictionary together with everything derived from it:
+ * the candidate store, the word index, the question cache its games share,
+ * and the opening book and decision tree when the files next to the
+ * dictionary match it. A snapshot never
+ * changes once built; games hold it by shared_ptr for as long as they run,
+ * so a reload never pulls words out from under a game in progress.
+ */
+class DictionarySnapshot {
+public:
+    DictionarySnapshot(const DictionarySnapshot&) = delete;
+    DictionarySnapshot& operator=(const DictionarySnapshot&) = delete;
+
+    // Loads dictionary.txt (or its compiled index) and the files beside it; nullptr if it is missing or empty.
+    static std::shared_ptr<const DictionarySnapshot> load(const std::string& textFile, uint64_t version);
+
+    uint64_t version() const { return version_; }
+    const Dictionary& dictionary() const { return dictionary_; }
+    const CandidateStore& store() const { return store_; }
+    const WordIndex& index() const { return *index_; }
+    const QuestionCache& questionCache() const { return cache_; }
+
+private:
+    explicit DictionarySnapshot(uint64_t version) : version_(version), store_(dictionary_) {}
+
+    uint64_t version_;
+    Dictionary dictionary_;
+    CandidateStore store_;
+    OpeningBook book_;
+    DecisionTree tree_;
+    QuestionCache cache_; // its entries only hold for this dictionary, so a reload starts a new one
+    std::optional<WordIndex> index_; // built once the dictionary is loaded
+};
+
+/**
+ * Keeps the current dictionary snapshot and replaces it when the files change.
+ * An inotify watch on the dictionary's directory wakes a background thread
+ * when dictionary.txt, or the .kdx, .book or .tree file beside it, is written
+ * or renamed into place. The thread waits for the writes to settle, builds a
+ * whole new snapshot off to the side and publishes it with one atomic store,
+ * so readers never wait: current() is a single atomic load, new games pick
+ * up the new version, and the old one is freed when its last game ends.
+ * A version that fails to load is reported and the current one kept.
+ */
+class DictionaryWatcher {
+public:
+    explicit DictionaryWatcher(std::string textFile) : textFile_(std::move(textFile)) {}
+    ~DictionaryWatcher();
+
+    DictionaryWatcher(const DictionaryWatcher&) = delete;
+    DictionaryWatcher& operator=(const DictionaryWatcher&) = delete;
+
+    // Loads the first snapshot; false if the dictionary cannot be loaded or is empty.
+    bool load();
+    // Starts reloading in the background on changes; false if the directory cannot be watched.
+    bool watch();
+
+    std::shared_ptr<const DictionarySnapshot> current() const { return current_.load(std::memory_order_acquire); }
+
+private:
+    void run();
+    void reload();
+
+    std::string textFile_;
+    std::atomic<std::shared_ptr<const DictionarySnapshot>> current_;
+    uint64_t versions_ = 0; // written by load() and then only by the watcher thread
+    int inotifyFd_ = -1;
+    int stopFd_ = -1; // eventfd that wakes the watcher thread to exit
+    std::thread thread_;
+};
+
+#endif // DICTIONARY_SNAPSHOT_HPP
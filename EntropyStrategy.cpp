@@ -0,0 +1,137 @@
+#include "EntropyStrategy.hpp"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+/**
+ * Counts how many candidates share each position mask for one letter.
+ * Open addressing with linear probing; only the slots used since the last
+ * clear() are reset, so reusing it across turns costs nothing extra.
+ */
+class MaskCounter {
+public:
+    void add(uint64_t mask) {
+        if ((used_.size() + 1) * 2 > keys_.size()) grow();
+        size_t slot = find(mask);
+        if (keys_[slot] == 0) {
+            keys_[slot] = mask;
+            used_.push_back(slot);
+        }
+        ++counts_[slot];
+    }
+
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t slot : used_) fn(counts_[slot]);
+    }
+
+    void clear() {
+        for (size_t slot : used_) {
+            keys_[slot] = 0;
+            counts_[slot] = 0;
+        }
+        used_.clear();
+    }
+
+private:
+    // Masks are never zero (the letter occurs somewhere), so zero marks an empty slot.
+    size_t find(uint64_t mask) const {
+        size_t slot = (mask * 0x9e3779b97f4a7c15ULL >> 20) & (keys_.size() - 1);
+        while (keys_[slot] != 0 && keys_[slot] != mask) {
+            slot = (slot + 1) & (keys_.size() - 1);
+        }
+        return slot;
+    }
+
+    void grow() {
+        std::vector<uint64_t> oldKeys = std::move(keys_);
+        std::vector<uint32_t> oldCounts = std::move(counts_);
+        keys_.assign(oldKeys.empty() ? 64 : oldKeys.size() * 2, 0);
+        counts_.assign(keys_.size(), 0);
+        used_.clear();
+        for (size_t i = 0; i < oldKeys.size(); ++i) {
+            if (oldKeys[i] == 0) continue;
+            size_t slot = find(oldKeys[i]);
+            keys_[slot] = oldKeys[i];
+            counts_[slot] = oldCounts[i];
+            used_.push_back(slot);
+        }
+    }
+
+    std::vector<uint64_t> keys_;
+    std::vector<uint32_t> counts_;
+    std::vector<size_t> used_;
+};
+
+// Sum of n * log2(n) over the partition sizes, the only part of the entropy that needs a scan.
+double sumNLogN(const MaskCounter& counter) {
+    double sum = 0;
+    counter.forEach([&](uint32_t n) { sum += n * std::log2(static_cast<double>(n)); });
+    return sum;
+}
+
+} // namespace
+
+/**
+ * Function to score every letter by the information its answer would give.
+ * One pass over the candidates builds each word's position mask per letter
+ * and counts the masks in a per-letter hash table.
+ * @param candidates The remaining candidate words.
+ * @param skipLetters Bit i set means letter 'a' + i was already asked.
+ * @return Entropy (bits) and candidate count per letter.
+ */
+LetterEntropy scoreLetterEntropy(const CandidateSet& candidates, uint32_t skipLetters) {
+    thread_local MaskCounter counters[kAlphabetSize]; // reused across turns and games
+
+    LetterEntropy result;
+    size_t total = 0;
+    candidates.forEach([&](std::string_view word) {
+        uint64_t masks[kAlphabetSize] = {};
+        uint32_t present = 0;
+        for (size_t i = 0; i < word.length() && i < 64; ++i) {
+            int slot = letterSlot(word[i]);
+            if (slot == kAlphabetSize || (skipLetters & (uint32_t{1} << slot))) continue;
+            masks[slot] |= uint64_t{1} << i;
+            present |= uint32_t{1} << slot;
+        }
+        while (present) {
+            int letter = __builtin_ctz(present);
+            counters[letter].add(masks[letter]);
+            ++result.counts[letter];
+            present &= present - 1;
+        }
+        ++total;
+    });
+
+    // H = log2(N) - (sum of n * log2(n) over all partitions) / N, with the
+    // "letter absent" partition holding N - count words.
+    for (int letter = 0; letter < kAlphabetSize; ++letter) {
+        if (result.counts[letter] == 0) continue;
+        double sum = sumNLogN(counters[letter]);
+        size_t absent = total - result.counts[letter];
+        if (absent > 0) sum += absent * std::log2(static_cast<double>(absent));
+        result.bits[letter] = std::log2(static_cast<double>(total)) - sum / total;
+        counters[letter].clear();
+    }
+    return result;
+}
+
+char chooseMaxEntropyLetter(const CandidateSet& candidates, uint32_t skipLetters) {
+    LetterEntropy scores = scoreLetterEntropy(candidates, skipLetters);
+
+    char bestLetter = '\0';
+    double bestBits = -1;
+    uint32_t bestCount = 0;
+    for (int letter = 0; letter < kAlphabetSize; ++letter) {
+        if (scores.counts[letter] == 0) continue;
+        // Compare with a small tolerance so ties fall through to the count
+        if (scores.bits[letter] > bestBits + 1e-9 ||
+            (scores.bits[letter] > bestBits - 1e-9 && scores.counts[letter] > bestCount)) {
+            bestLetter = static_cast<char>('a' + letter);
+            bestBits = scores.bits[letter];
+            bestCount = scores.counts[letter];
+        }
+    }
+    return bestLetter;
+}
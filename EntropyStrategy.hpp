@@ -0,0 +1,25 @@
+#ifndef ENTROPY_STRATEGY_HPP
+#define ENTROPY_STRATEGY_HPP
+
+#include "CandidateStore.hpp"
+#include <cstdint>
+
+/**
+ * Expected information, in bits, of asking about each letter.
+ * Asking about a letter splits the candidates by the exact set of positions
+ * the letter occupies (the "no" answer being the empty set); the score is the
+ * entropy of that partition.
+ */
+struct LetterEntropy {
+    double bits[kAlphabetSize] = {};
+    LetterHistogram counts{}; // candidates containing each letter
+};
+
+// Scores every letter not in skipLetters against the remaining candidates.
+LetterEntropy scoreLetterEntropy(const CandidateSet& candidates, uint32_t skipLetters);
+
+// Picks the letter with the highest expected information (ties go to the more
+// common letter), or '\0' if no remaining candidate contains an unasked letter.
+char chooseMaxEntropyLetter(const CandidateSet& candidates, uint32_t skipLetters);
+
+#endif // ENTROPY_STRATEGY_HPP
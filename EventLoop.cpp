@@ -0,0 +1,220 @@
+#include "EventLoop.hpp"
+#include <cctype>
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int kMaxEvents = 64;
+
+uint64_t eventTag(int fd, uint32_t generation) {
+    return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(fd);
+}
+
+bool isSpace(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+} // namespace
+
+EventLoop::EventLoop() : epollFd_(epoll_create1(EPOLL_CLOEXEC)) {}
+
+EventLoop::~EventLoop() {
+    for (auto& [fd, handler] : handlers_) {
+        if (handler.timer) ::close(fd);
+    }
+    if (epollFd_ >= 0) ::close(epollFd_);
+}
+
+bool EventLoop::add(int fd, Callback callback, bool timer) {
+    if (epollFd_ < 0) return false;
+    remove(fd);
+
+    uint32_t generation = nextGeneration_++;
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = eventTag(fd, generation);
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) != 0) return false;
+    handlers_[fd] = Handler{std::move(callback), generation, timer};
+    return true;
+}
+
+void EventLoop::remove(int fd) {
+    auto it = handlers_.find(fd);
+    if (it == handlers_.end()) return;
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+    if (it->second.timer) ::close(fd);
+    handlers_.erase(it);
+}
+
+bool EventLoop::watch(int fd, Callback onReadable) {
+    return add(fd, std::move(onReadable), false);
+}
+
+void EventLoop::unwatch(int fd) {
+    remove(fd);
+}
+
+/**
+ * Function to arm a one-shot deadline.
+ * The id comes from a counter rather than being the timerfd: a fired timer's
+ * fd is closed and its number may be reused by the next timer, which a late
+ * cancelTimer must not touch.
+ * @param delay How long from now the timer fires.
+ * @param onExpire Called once when it fires.
+ * @return The timer id, or 0 if the timerfd could not be created.
+ */
+EventLoop::TimerId EventLoop::addTimer(std::chrono::steady_clock::duration delay, Callback onExpire) {
+    int timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer < 0) return 0;
+
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count();
+    if (nanos <= 0) nanos = 1; // an all-zero it_value would disarm the timer
+    itimerspec spec{};
+    spec.it_value.tv_sec = static_cast<time_t>(nanos / 1000000000);
+    spec.it_value.tv_nsec = static_cast<long>(nanos % 1000000000);
+    if (timerfd_settime(timer, 0, &spec, nullptr) != 0) {
+        ::close(timer);
+        return 0;
+    }
+
+    // Fires once: drop the timer before running the callback
+    TimerId id = nextTimer_++;
+    bool added = add(timer, [this, id, timer, onExpire = std::move(onExpire)]() {
+        timers_.erase(id);
+        remove(timer);
+        onExpire();
+    }, true);
+    if (!added) {
+        ::close(timer);
+        return 0;
+    }
+    timers_[id] = timer;
+    return id;
+}
+
+void EventLoop::cancelTimer(TimerId timer) {
+    auto it = timers_.find(timer);
+    if (it == timers_.end()) return;
+    remove(it->second);
+    timers_.erase(it);
+}
+
+bool EventLoop::runOnce(int timeoutMs) {
+    if (epollFd_ < 0) return false;
+
+    epoll_event events[kMaxEvents];
+    int ready = epoll_wait(epollFd_, events, kMaxEvents, timeoutMs);
+    if (ready < 0) return errno == EINTR;
+
+    for (int i = 0; i < ready; ++i) {
+        int fd = static_cast<int>(static_cast<uint32_t>(events[i].data.u64));
+        uint32_t generation = static_cast<uint32_t>(events[i].data.u64 >> 32);
+
+        // An earlier callback in this batch may have removed or replaced the handler
+        auto it = handlers_.find(fd);
+        if (it == handlers_.end() || it->second.generation != generation) continue;
+        Callback callback = it->second.callback; // the callback may erase its own handler
+        callback();
+    }
+    return true;
+}
+
+void EventLoop::run() {
+    stopping_ = false;
+    while (!stopping_ && runOnce()) {
+    }
+}
+
+bool InputReader::fill() {
+    if (closed_) return false;
+
+    // Drop the consumed prefix before it grows
+    if (start_ > 0 && start_ * 2 >= buffer_.size()) {
+        buffer_.erase(0, start_);
+        start_ = 0;
+    }
+
+    char chunk[4096];
+    ssize_t count = ::read(fd_, chunk, sizeof(chunk));
+    if (count > 0) {
+        buffer_.append(chunk, static_cast<size_t>(count));
+    } else if (count == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        closed_ = true;
+    }
+    return !closed_;
+}
+
+/**
+ * Function to take the next word from the buffer.
+ * A word is complete once whitespace follows it, or at the end of a closed input.
+ * @param word Receives the word.
+ * @return True if a word was taken, false if more input is needed.
+ */
+bool InputReader::nextWord(std::string& word) {
+    size_t begin = start_;
+    while (begin < buffer_.size() && isSpace(buffer_[begin])) ++begin;
+    size_t end = begin;
+    while (end < buffer_.size() && !isSpace(buffer_[end])) ++end;
+
+    if (begin == end || (end == buffer_.size() && !closed_)) {
+        start_ = begin;
+        return false;
+    }
+    word.assign(buffer_, begin, end - begin);
+    start_ = end;
+    return true;
+}
+
+bool InputReader::nextLine(std::string& line) {
+    size_t end = buffer_.find('\n', start_);
+    if (end == std::string::npos) {
+        if (!closed_ || start_ == buffer_.size()) return false;
+        end = buffer_.size(); // last line of a closed input
+    }
+    line.assign(buffer_, start_, end - start_);
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    start_ = end < buffer_.size() ? end + 1 : end;
+    return true;
+}
+
+/**
+ * Function to wait for the next word.
+ * Sleeps in epoll until input arrives or the deadline's timerfd fires.
+ * @param word Receives the word; left untouched if none came.
+ * @param timeLimitSeconds The time limit in seconds, or 0 for none.
+ * @return Ok, TimedOut, or Closed at the end of the input.
+ */
+InputReader::Status InputReader::readWord(std::string& word, int timeLimitSeconds) {
+    if (nextWord(word)) return Status::Ok;
+    if (closed_) return Status::Closed;
+
+    if (!loop_) loop_ = std::make_unique<EventLoop>();
+    bool timedOut = false;
+    EventLoop::TimerId timer = 0;
+    if (timeLimitSeconds > 0) {
+        timer = loop_->addTimer(std::chrono::seconds(timeLimitSeconds), [&timedOut]() { timedOut = true; });
+    }
+    bool waiting = loop_->watch(fd_, [this]() { fill(); });
+
+    Status status = Status::Closed;
+    while (true) {
+        if (!waiting) fill(); // no epoll (e.g., a regular file): plain blocking reads
+        if (nextWord(word)) {
+            status = Status::Ok;
+            break;
+        }
+        if (closed_) break;
+        if (timedOut) {
+            status = Status::TimedOut;
+            break;
+        }
+        if (waiting && !loop_->runOnce()) break;
+    }
+
+    loop_->unwatch(fd_);
+    loop_->cancelTimer(timer);
+    return status;
+}
@@ -0,0 +1,99 @@
+#ifndef EVENT_LOOP_HPP
+#define EVENT_LOOP_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Single-threaded reactor over epoll.
+ * File descriptors are watched for input and deadlines are timerfds in the
+ * same epoll set, so one epoll_wait wakes exactly when input arrives or a
+ * deadline passes; nothing is polled on an interval. Callbacks run on the
+ * thread calling runOnce()/run() and may watch, unwatch, add or cancel freely.
+ */
+class EventLoop {
+public:
+    using Callback = std::function<void()>;
+    using TimerId = uint64_t; // never reused, unlike the timerfd behind it
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // False if the epoll instance could not be created.
+    bool valid() const { return epollFd_ >= 0; }
+
+    // Calls onReadable whenever fd has input (or hung up). Replaces an earlier watch of fd.
+    bool watch(int fd, Callback onReadable);
+    void unwatch(int fd);
+
+    // Calls onExpire once, delay from now. Returns an id for cancelTimer, or 0 on failure.
+    TimerId addTimer(std::chrono::steady_clock::duration delay, Callback onExpire);
+    // Cancels a timer that has not fired yet; a no-op for one that has (or for 0).
+    void cancelTimer(TimerId timer);
+
+    // Waits for events (at most timeoutMs, -1 for no limit) and dispatches them.
+    // @return False if waiting failed.
+    bool runOnce(int timeoutMs = -1);
+    // Dispatches events until stop() is called.
+    void run();
+    void stop() { stopping_ = true; }
+
+private:
+    struct Handler {
+        Callback callback;
+        uint32_t generation; // tells a reused fd number from the one an event was queued for
+        bool timer;
+    };
+
+    bool add(int fd, Callback callback, bool timer);
+    void remove(int fd);
+
+    int epollFd_;
+    uint32_t nextGeneration_ = 0;
+    TimerId nextTimer_ = 1;
+    bool stopping_ = false;
+    std::unordered_map<int, Handler> handlers_;
+    std::unordered_map<TimerId, int> timers_; // pending timers and their timerfds
+};
+
+/**
+ * Buffered reader of whitespace-separated words from a file descriptor,
+ * the event-driven counterpart of `std::cin >> word`.
+ * fill() and nextWord() never block, so a server can feed many readers
+ * from its own loop; readWord() runs a private loop for one blocking read.
+ */
+class InputReader {
+public:
+    enum class Status { Ok, TimedOut, Closed };
+
+    explicit InputReader(int fd) : fd_(fd) {}
+
+    int fd() const { return fd_; }
+    bool closed() const { return closed_; }
+
+    // Reads whatever input is available into the buffer. False once the input is closed.
+    bool fill();
+    // Takes the next complete word from the buffer, if there is one.
+    bool nextWord(std::string& word);
+    // Takes the next complete line (without its newline) from the buffer, if there is one.
+    bool nextLine(std::string& line);
+
+    // Waits for the next word, up to timeLimitSeconds if positive.
+    Status readWord(std::string& word, int timeLimitSeconds = 0);
+
+private:
+    int fd_;
+    bool closed_ = false;
+    std::string buffer_;
+    size_t start_ = 0; // first unread character of buffer_
+    std::unique_ptr<EventLoop> loop_; // created by the first readWord() that has to wait
+};
+
+#endif // EVENT_LOOP_HPP
@@ -0,0 +1,51 @@
+#include "GameArena.hpp"
+#include <new>
+
+/**
+ * Function to take a piece from the arena.
+ * A freed piece of the same size is reused first; otherwise the piece is cut
+ * from the current block, and a new block is taken from the heap when it is full.
+ * @param bytes The size of the piece.
+ * @return The piece, aligned for any type.
+ */
+void* GameArena::allocate(size_t bytes) {
+    bytes = roundUp(bytes < sizeof(FreePiece) ? sizeof(FreePiece) : bytes);
+    FreeList& list = freeList(bytes);
+    if (list.head) {
+        FreePiece* piece = list.head;
+        list.head = piece->next;
+        return piece;
+    }
+
+    if (bytes > left_) {
+        size_t blockBytes = bytes > kBlockBytes ? bytes : kBlockBytes;
+        blocks_.push_back(std::make_unique<std::byte[]>(blockBytes));
+        next_ = blocks_.back().get();
+        left_ = blockBytes;
+        reservedBytes_ += blockBytes;
+    }
+    void* piece = next_;
+    next_ += bytes;
+    left_ -= bytes;
+    return piece;
+}
+
+void GameArena::release(void* memory, size_t bytes) {
+    if (!memory) return;
+    bytes = roundUp(bytes < sizeof(FreePiece) ? sizeof(FreePiece) : bytes);
+    FreeList& list = freeList(bytes);
+    list.head = new (memory) FreePiece{list.head};
+}
+
+GameArena::FreeList& GameArena::freeList(size_t bytes) {
+    for (FreeList& list : freeLists_) {
+        if (list.bytes == bytes) return list;
+    }
+    freeLists_.push_back(FreeList{bytes, nullptr});
+    return freeLists_.back();
+}
+
+GameArena& threadArena() {
+    thread_local GameArena arena;
+    return arena;
+}
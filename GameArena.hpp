@@ -0,0 +1,73 @@
+#ifndef GAME_ARENA_HPP
+#define GAME_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * Per-thread memory for the scratch data of games.
+ * Pieces are carved from large blocks, monotonically, and never go back to
+ * the heap: a freed piece goes on the free list for its size and is handed
+ * out again. Games ask for the same few sizes over and over (their coroutine
+ * frame, their undo bookkeeping), so once a thread has played a game of each
+ * kind, later games take all of it from the arena and never call the heap.
+ * A piece must be freed on the thread that allocated it.
+ */
+class GameArena {
+public:
+    GameArena() = default;
+    GameArena(const GameArena&) = delete;
+    GameArena& operator=(const GameArena&) = delete;
+
+    void* allocate(size_t bytes);
+    // Gives a piece back; bytes must be what was asked for.
+    void release(void* memory, size_t bytes);
+
+    // Bytes taken from the heap so far.
+    size_t reservedBytes() const { return reservedBytes_; }
+
+private:
+    struct FreePiece {
+        FreePiece* next;
+    };
+    struct FreeList {
+        size_t bytes;
+        FreePiece* head;
+    };
+
+    static constexpr size_t kAlignment = alignof(std::max_align_t);
+    static constexpr size_t kBlockBytes = 64 * 1024;
+
+    static size_t roundUp(size_t bytes) { return (bytes + kAlignment - 1) & ~(kAlignment - 1); }
+    FreeList& freeList(size_t bytes);
+
+    std::vector<std::unique_ptr<std::byte[]>> blocks_;
+    std::byte* next_ = nullptr; // unused part of the newest block
+    size_t left_ = 0;
+    size_t reservedBytes_ = 0;
+    std::vector<FreeList> freeLists_; // one per size seen; games use only a handful
+};
+
+// The calling thread's arena.
+GameArena& threadArena();
+
+/**
+ * Standard allocator over the calling thread's arena, for containers that live within one game.
+ */
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    ArenaAllocator() = default;
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(threadArena().allocate(count * sizeof(T))); }
+    void deallocate(T* memory, size_t count) { threadArena().release(memory, count * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const { return true; }
+};
+
+#endif // GAME_ARENA_HPP
@@ -0,0 +1,14 @@
+#include "GameEngine.hpp"
+
+/**
+ * Function to display the guessed word with better formatting
+ * @param guessedWord The current state of the guessed word.
+ * @param out The stream to display it on.
+ */
+void displayGuessedWord(const std::string& guessedWord, std::ostream& out) {
+    out << "\nCurrent Word: ";
+    for (char c : guessedWord) {
+        out << (c == '_' ? "_ " : std::string(1, c) + " ");
+    }
+    out << "\n";
+}
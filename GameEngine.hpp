@@ -0,0 +1,231 @@
+#ifndef GAME_ENGINE_HPP
+#define GAME_ENGINE_HPP
+
+#include "Strategy.hpp"
+#include "GameState.hpp"
+#include "GameArena.hpp"
+#include "GameIO.hpp"
+#include "GameTask.hpp"
+#include "Profile.hpp"
+#include "Random.hpp"
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Draws the revealed pattern as "Current Word: a _ _ l e".
+void displayGuessedWord(const std::string& guessedWord, std::ostream& out);
+
+// Whole microseconds of a duration, as the log stores them.
+inline uint32_t logMicros(std::chrono::steady_clock::duration time) {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(time).count());
+}
+
+// The log record for one answered question.
+inline LogRecord questionRecord(const Question& question, const std::string& response, int turn,
+                                std::chrono::steady_clock::duration answerTime,
+                                std::chrono::steady_clock::duration decisionTime) {
+    LogRecord record;
+    record.turn = static_cast<uint16_t>(turn);
+    record.kind = question.kind == Question::Kind::Letter ? 'L' : 'W';
+    LogRecord::setField(record.question, sizeof(record.question),
+                        question.kind == Question::Kind::Letter ? std::string_view(&question.letter, 1) : question.word);
+    LogRecord::setField(record.answer, sizeof(record.answer), response);
+    record.answerMicros = logMicros(answerTime);
+    record.decisionMicros = logMicros(decisionTime);
+    return record;
+}
+
+// The log record that opens a game: the secret word, the random seed and the dictionary it is played on.
+inline LogRecord gameStartRecord(std::string_view secretWord, uint64_t seed, uint64_t dictionary) {
+    LogRecord record;
+    record.kind = 'S';
+    record.seed = seed;
+    record.dictionary = dictionary;
+    LogRecord::setField(record.question, sizeof(record.question), secretWord);
+    return record;
+}
+
+// The log record that closes a game after the given number of questions.
+inline LogRecord gameEndRecord(bool won, int turns) {
+    LogRecord record;
+    record.kind = 'E';
+    record.turn = static_cast<uint16_t>(turns);
+    LogRecord::setField(record.answer, sizeof(record.answer), won ? "win" : "lose");
+    return record;
+}
+
+/**
+ * One game of a strategy under the given rules, as a coroutine.
+ * Each question is co_yielded and the game resumes with the raw response,
+ * so the same code is played by the blocking runGame loop below and by
+ * event-driven callers that park many games between answers (GameServer).
+ * Templated on the strategy so that, instantiated for a concrete final type,
+ * it makes no virtual calls; gameLoop<Strategy> plays any strategy.
+ * Every argument must outlive the task.
+ */
+template <typename S>
+GameTask gameLoop(S& strategy, const GameRules& rules, const std::string& secretWord, GameState& state, std::ostream& out) {
+    int questionsAsked = 0;
+    [[maybe_unused]] int turn = 0; // questions put to the player, for the profile and probes
+    std::vector<int, ArenaAllocator<int>> answerCost; // questions each applied answer used up, for undo
+    answerCost.reserve(kLetterSlots);                  // one entry per letter asked, so it never grows in play
+    PROFILE_COUNT(Games, 1);
+    KNOWSALL_PROBE1(game_start, secretWord.length());
+
+    out << rules.intro;
+    if (rules.missPenalty > 0) {
+        out << "Rules: Knowsall has only " << rules.maxQuestions << " guesses, and incorrect guesses will cost extra.\n";
+    }
+    if (rules.allowUndo) {
+        out << "Answer 'undo' to take back your previous answer.\n";
+    }
+
+    while (questionsAsked < rules.maxQuestions && !state.solved()) {
+        co_await GameTask::BeforeQuestion{}; // a lockstep driver may fill in shared work here
+        PROFILE_TURN(turn, state.candidates().count());
+        Question question;
+        {
+            PROFILE_SCOPE(Choose);
+            question = strategy.nextQuestion(state);
+        }
+        if (question.empty()) {
+            if (state.candidates().empty()) {
+                out << "Knowsall has no more possible words to guess.\n";
+            } else if (question.kind == Question::Kind::Letter) {
+                out << "Knowsall has run out of letters to guess.\n";
+            } else {
+                out << "Knowsall has run out of words to guess.\n";
+            }
+            break;
+        }
+
+        ++turn;
+        PROFILE_COUNT(Questions, 1);
+        KNOWSALL_PROBE2(question, turn, question.letter);
+        std::string response = co_yield question;
+
+        // Take back the previous answer; the question just asked will come up again
+        if (rules.allowUndo && response == "undo") {
+            if (!state.undo()) {
+                out << "There is no answer to take back.\n";
+                continue;
+            }
+            questionsAsked -= answerCost.back();
+            answerCost.pop_back();
+            displayGuessedWord(state.pattern(), out);
+            out << "Questions remaining: " << (rules.maxQuestions - questionsAsked) << "\n";
+            continue;
+        }
+
+        // Handle invalid responses
+        if (response != "yes" && response != "no") {
+            out << "Invalid response. Please answer 'yes' or 'no'.\n";
+            if (question.kind == Question::Kind::Letter) {
+                state.apply(LetterAnswer{question.letter, 0}); // The letter still counts as guessed
+                answerCost.push_back(0);
+            }
+            continue; // Skip to the next iteration
+        }
+
+        bool yes = response == "yes";
+        if (question.kind == Question::Kind::Word) {
+            if (yes) {
+                out << "Knowsall guessed your word: " << question.word << "\n";
+                KNOWSALL_PROBE2(game_end, 1, questionsAsked);
+                co_return GameResult{true, questionsAsked};
+            }
+            strategy.observe(Answer{question, false, 0});
+            ++questionsAsked;
+            continue;
+        }
+
+        LetterAnswer answer = yes ? GameState::answerFor(secretWord, question.letter) : LetterAnswer{question.letter, 0};
+        state.apply(answer);
+
+        int cost = 1;
+        if (yes) {
+            if (rules.showBoard) {
+                displayGuessedWord(state.pattern(), out);
+            } else {
+                out << "Updated word: " << state.pattern() << "\n";
+            }
+        } else if (rules.missPenalty > 0) {
+            out << "Incorrect guess! Knowsall loses an extra chance.\n";
+            cost += rules.missPenalty;
+        }
+        strategy.observe(Answer{question, yes, answer.positions});
+
+        questionsAsked += cost;
+        answerCost.push_back(cost);
+        out << "Questions remaining: " << (rules.maxQuestions - questionsAsked) << "\n";
+    }
+
+    if (state.solved()) {
+        out << "Knowsall guessed your word: " << secretWord << "\n";
+        KNOWSALL_PROBE2(game_end, 1, questionsAsked);
+        co_return GameResult{true, questionsAsked};
+    }
+    out << "Knowsall couldn't guess your word within " << rules.maxQuestions << " questions.\n";
+    KNOWSALL_PROBE2(game_end, 0, questionsAsked);
+    co_return GameResult{false, questionsAsked};
+}
+
+/**
+ * Plays one game of a strategy against io under the given rules,
+ * blocking on io for every answer.
+ * Templated on the strategy and the IO so that, instantiated for concrete
+ * final types, the question loop makes no virtual calls.
+ * @return True if Knowsall guessed the word.
+ */
+template <typename S, typename IO>
+bool runGame(S& strategy, const GameRules& rules, const std::string& secretWord, GameState& state, IO& io) {
+    using Clock = std::chrono::steady_clock;
+    GameTask game = gameLoop(strategy, rules, secretWord, state, io.out());
+    int turn = 0;
+
+    auto decidingFrom = Clock::now();
+    game.start();
+    while (!game.finished()) {
+        const Question& question = game.question();
+        auto askedAt = Clock::now();
+        std::string response = io.ask(question, rules.timeLimitSeconds);
+        ++turn;
+        if (rules.logAnswers) {
+            io.log(questionRecord(question, response, turn, Clock::now() - askedAt, askedAt - decidingFrom)); // Log the guess and response
+        }
+        decidingFrom = Clock::now();
+        game.resume(std::move(response));
+    }
+    if (rules.logAnswers) io.log(gameEndRecord(game.result().won, turn));
+    return game.result().won;
+}
+
+/**
+ * Builds strategy S for the secret word and plays one game with it.
+ * &playWith<S, IO> is what the registry stores for each mode.
+ * The caller seeds the thread's random engine first (seedGameRng or
+ * reseedGameRng); a logged game records that seed.
+ */
+template <typename S, typename IO>
+bool playWith(const StrategyInfo& info, const std::string& secretWord, const CandidateStore& store, IO& io) {
+    // One state per thread, reset for every game, so its memory is only allocated once
+    thread_local std::unique_ptr<GameState> state;
+    if (state) {
+        state->reset(store, secretWord.length());
+    } else {
+        state = std::make_unique<GameState>(store, secretWord.length());
+    }
+    S strategy(store, secretWord.length());
+    if (info.rules.logAnswers) io.log(gameStartRecord(secretWord, gameSeed(), store.dictionary().fingerprint()));
+    return runGame(strategy, info.rules, secretWord, *state, io);
+}
+
+// Builds strategy S behind the Strategy interface, for games driven by gameLoop<Strategy>.
+template <typename S>
+std::unique_ptr<Strategy> makeStrategy(const CandidateStore& store, size_t length) {
+    return std::make_unique<S>(store, length);
+}
+
+#endif // GAME_ENGINE_HPP
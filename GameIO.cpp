@@ -0,0 +1,97 @@
+#include "GameIO.hpp"
+#include "EventLoop.hpp"
+#include "Profile.hpp"
+#include <iostream>
+#include <unistd.h>
+
+namespace {
+
+// The reader shared by everything that reads the console, so no word sits unseen in another buffer.
+InputReader& consoleInput() {
+    static InputReader reader(STDIN_FILENO);
+    return reader;
+}
+
+} // namespace
+
+/**
+ * Function to read the next word typed on the console.
+ * @param word Receives the word.
+ * @return True if a word was read, false at the end of the input.
+ */
+bool readConsoleWord(std::string& word) {
+    std::cout.flush(); // the prompt has to show before we wait
+    return consoleInput().readWord(word) == InputReader::Status::Ok;
+}
+
+/**
+ * Function to add a timer for user responses
+ * Waits in epoll on stdin and a timerfd, so it wakes as soon as the user
+ * answers or the time is up.
+ * @param response The user's response.
+ * @param timeLimitSeconds The time limit in seconds.
+ * @return True if the user responded within the time limit, false otherwise.
+ */
+bool getUserResponseWithTimer(std::string& response, int timeLimitSeconds) {
+    std::cout.flush();
+    InputReader::Status status = consoleInput().readWord(response, timeLimitSeconds);
+    if (status == InputReader::Status::TimedOut) {
+        std::cout << "\nTime's up! Proceeding automatically...\n";
+        response = "no"; // Default response if time runs out
+        return false;
+    }
+    return status == InputReader::Status::Ok;
+}
+
+std::string ConsoleIO::ask(const Question& question, int timeLimitSeconds) {
+    PROFILE_SCOPE(IO);
+    if (question.kind == Question::Kind::Letter) {
+        std::cout << "Is the letter '" << question.letter << "' in your word? (yes/no): ";
+    } else {
+        std::cout << "Is your word '" << question.word << "'? (yes/no): ";
+    }
+
+    std::string response;
+    if (timeLimitSeconds > 0) {
+        getUserResponseWithTimer(response, timeLimitSeconds);
+    } else {
+        readConsoleWord(response);
+    }
+    return response;
+}
+
+std::ostream& ConsoleIO::out() {
+    return std::cout;
+}
+
+/**
+ * Function to log guesses and responses
+ * Hands the record to the asynchronous game log, so no file is touched here.
+ * @param record The question, the response and how long it took.
+ */
+void ConsoleIO::log(LogRecord record) {
+    record.gameId = gameId_;
+    LogRecord::setField(record.strategy, sizeof(record.strategy), strategy_);
+    defaultGameLog().write(record);
+}
+
+void ConsoleIO::startGame(std::string_view strategy) {
+    ++gameId_;
+    strategy_ = strategy;
+}
+
+std::string OracleIO::ask(const Question& question, int) {
+    PROFILE_SCOPE(IO);
+    ++questionsAsked_;
+    bool yes = question.kind == Question::Kind::Letter
+        ? secretWord_.find(question.letter) != std::string_view::npos
+        : question.word == secretWord_;
+    return yes ? "yes" : "no";
+}
+
+void OracleIO::log(LogRecord record) {
+    if (!gameLog_) return;
+    record.gameId = gameId_;
+    LogRecord::setField(record.strategy, sizeof(record.strategy), strategy_);
+    gameLog_->write(record);
+}
@@ -0,0 +1,90 @@
+#ifndef GAME_IO_HPP
+#define GAME_IO_HPP
+
+#include "GameLog.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/**
+ * A yes/no question Knowsall asks about the secret word.
+ */
+struct Question {
+    enum class Kind { Letter, Word };
+
+    Kind kind = Kind::Letter;
+    char letter = '\0';     // set for Kind::Letter
+    std::string_view word;  // set for Kind::Word
+
+    static Question aboutLetter(char letter) { return Question{Kind::Letter, letter, {}}; }
+    static Question aboutWord(std::string_view word) { return Question{Kind::Word, '\0', word}; }
+
+    // True for the "nothing left to ask" question (no letter, or no word).
+    bool empty() const { return kind == Kind::Letter ? letter == '\0' : word.empty(); }
+};
+
+/**
+ * The other side of a game: whoever answers Knowsall's questions.
+ * The game engine only talks to this interface, so the same mode can be played
+ * on the terminal or headless against an oracle that knows the secret word.
+ */
+class GameIO {
+public:
+    virtual ~GameIO() = default;
+
+    // Asks a question and returns the raw response ("yes", "no" or anything else).
+    // A positive time limit lets interactive players run out of time.
+    virtual std::string ask(const Question& question, int timeLimitSeconds = 0) = 0;
+    // Stream for progress messages; headless players discard them.
+    virtual std::ostream& out() = 0;
+    // Records a question and its answer in the game log; the IO fills in the game id and strategy.
+    virtual void log(LogRecord record) = 0;
+};
+
+// Reads the next word typed on the console; false at the end of the input.
+// Every console read goes through this, never std::cin.
+bool readConsoleWord(std::string& word);
+
+/**
+ * Plays on stdin/stdout, as the interactive game always has.
+ */
+class ConsoleIO final : public GameIO {
+public:
+    std::string ask(const Question& question, int timeLimitSeconds = 0) override;
+    std::ostream& out() override;
+    void log(LogRecord record) override;
+
+    // Starts numbering the log records of a new game played with this strategy.
+    void startGame(std::string_view strategy);
+
+private:
+    uint64_t gameId_ = 0;
+    std::string strategy_;
+};
+
+/**
+ * Answers truthfully from a known secret word, without any output.
+ */
+class OracleIO final : public GameIO {
+public:
+    explicit OracleIO(std::string_view secretWord, GameLog* gameLog = nullptr, uint64_t gameId = 0, std::string_view strategy = {})
+        : secretWord_(secretWord), discard_(nullptr), gameLog_(gameLog), gameId_(gameId), strategy_(strategy) {}
+
+    std::string ask(const Question& question, int timeLimitSeconds = 0) override;
+    std::ostream& out() override { return discard_; }
+    void log(LogRecord record) override;
+
+    // Number of questions asked so far.
+    int questionsAsked() const { return questionsAsked_; }
+
+private:
+    std::string_view secretWord_;
+    std::ostream discard_; // no stream buffer, so every write is dropped
+    int questionsAsked_ = 0;
+    GameLog* gameLog_;     // where log() goes; nullptr drops it
+    uint64_t gameId_;
+    std::string_view strategy_;
+};
+
+#endif // GAME_IO_HPP
@@ -0,0 +1,360 @@
+#include "GameLog.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+constexpr char kLogMagic[8] = {'K', 'N', 'O', 'W', 'S', 'L', 'O', 'G'};
+constexpr uint32_t kLogVersion = 2; // 2 added game start and end records, seeds and decision times
+
+struct LogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize; // sizeof(LogRecord), so readers can check the layout
+};
+
+// How long the writer sleeps when the ring is empty; bounds the delay before a record reaches the file.
+constexpr auto kIdleWait = std::chrono::milliseconds(10);
+
+// Writes a NUL-padded field as a JSON string.
+void writeJsonString(std::ostream& out, const char* field, size_t size) {
+    static const char kHex[] = "0123456789abcdef";
+    out << '"';
+    for (size_t i = 0; i < size && field[i] != '\0'; ++i) {
+        unsigned char c = static_cast<unsigned char>(field[i]);
+        if (c == '"' || c == '\\') {
+            out << '\\' << static_cast<char>(c);
+        } else if (c < 0x20) {
+            out << "\\u00" << kHex[c >> 4] << kHex[c & 0xf];
+        } else {
+            out << static_cast<char>(c);
+        }
+    }
+    out << '"';
+}
+
+// Writes a 64-bit value as a JSON string of 16 hex digits, which JSON numbers cannot hold exactly.
+void writeJsonHex(std::ostream& out, uint64_t value) {
+    out << '"' << std::hex << std::setw(16) << std::setfill('0') << value << std::dec << std::setfill(' ') << '"';
+}
+
+// Reads a JSON string starting at text[at] (the opening quote) into value; false if it is malformed.
+bool readJsonString(std::string_view text, size_t& at, std::string& value) {
+    if (at >= text.size() || text[at] != '"') return false;
+    value.clear();
+    for (++at; at < text.size(); ++at) {
+        char c = text[at];
+        if (c == '"') {
+            ++at;
+            return true;
+        }
+        if (c != '\\') {
+            value += c;
+            continue;
+        }
+        if (++at == text.size()) return false;
+        if (text[at] == 'u') {
+            if (at + 4 >= text.size()) return false;
+            value += static_cast<char>(std::strtoul(std::string(text.substr(at + 1, 4)).c_str(), nullptr, 16));
+            at += 4;
+        } else {
+            value += text[at] == 'n' ? '\n' : text[at] == 't' ? '\t' : text[at];
+        }
+    }
+    return false;
+}
+
+/**
+ * Function to parse one line of a JSONL game log.
+ * Only the flat objects GameLog writes are understood: string and unsigned
+ * integer values. Unknown keys are skipped, so version 1 lines read as
+ * question records without a decision time.
+ * @return True if the line was a well-formed record.
+ */
+bool parseJsonRecord(std::string_view line, LogRecord& record) {
+    record = LogRecord();
+    size_t at = line.find('{');
+    if (at == std::string_view::npos) return false;
+    ++at;
+    std::string key, text;
+    while (true) {
+        while (at < line.size() && (line[at] == ' ' || line[at] == ',')) ++at;
+        if (at < line.size() && line[at] == '}') return true;
+        if (!readJsonString(line, at, key) || at >= line.size() || line[at] != ':') return false;
+        ++at;
+
+        uint64_t number = 0;
+        bool isString = at < line.size() && line[at] == '"';
+        if (isString) {
+            if (!readJsonString(line, at, text)) return false;
+        } else {
+            size_t digits = at;
+            while (at < line.size() && line[at] >= '0' && line[at] <= '9') number = number * 10 + (line[at++] - '0');
+            if (at == digits) return false;
+        }
+
+        if (key == "game") {
+            record.gameId = number;
+        } else if (key == "strategy") {
+            LogRecord::setField(record.strategy, sizeof(record.strategy), text);
+        } else if (key == "turn" || key == "turns") {
+            record.turn = static_cast<uint16_t>(number);
+        } else if (key == "kind") {
+            record.kind = text == "start" ? 'S' : text == "end" ? 'E' : text == "word" ? 'W' : 'L';
+        } else if (key == "question" || key == "word") {
+            LogRecord::setField(record.question, sizeof(record.question), text);
+        } else if (key == "answer" || key == "result") {
+            LogRecord::setField(record.answer, sizeof(record.answer), text);
+        } else if (key == "micros") {
+            record.answerMicros = static_cast<uint32_t>(number);
+        } else if (key == "decision_micros") {
+            record.decisionMicros = static_cast<uint32_t>(number);
+        } else if (key == "seed") {
+            record.seed = std::strtoull(text.c_str(), nullptr, 16);
+        } else if (key == "dictionary") {
+            record.dictionary = std::strtoull(text.c_str(), nullptr, 16);
+        }
+    }
+}
+
+} // namespace
+
+void LogRecord::setField(char* field, size_t size, std::string_view value) {
+    size_t length = value.size() < size ? value.size() : size;
+    std::memcpy(field, value.data(), length);
+    std::memset(field + length, 0, size - length);
+}
+
+GameLog::GameLog(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+    slots_.reset(new Slot[size]);
+    mask_ = size - 1;
+    for (size_t i = 0; i < size; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+GameLog::~GameLog() {
+    close();
+}
+
+/**
+ * Function to open the log file and start the writer thread.
+ * @param filename The file to append to.
+ * @param format JSONL or binary records.
+ * @return True if the file was opened, false otherwise.
+ */
+bool GameLog::open(const std::string& filename, LogFormat format) {
+    close();
+
+    file_.open(filename, format == LogFormat::Binary ? std::ios::binary | std::ios::app : std::ios::app);
+    if (!file_.is_open()) {
+        std::cerr << "Error: Could not open game log: " << filename << "\n";
+        return false;
+    }
+    format_ = format;
+
+    // A new binary file starts with a header; appending to an existing one continues its records
+    if (format_ == LogFormat::Binary && file_.tellp() == 0) {
+        LogHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, kLogMagic, sizeof(kLogMagic));
+        header.version = kLogVersion;
+        header.recordSize = sizeof(LogRecord);
+        file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    stopping_.store(false, std::memory_order_relaxed);
+    writer_ = std::thread(&GameLog::run, this);
+    return true;
+}
+
+/**
+ * Function to stop the writer once everything queued is in the file.
+ * Call it after the threads writing to the log are done.
+ */
+void GameLog::close() {
+    if (!writer_.joinable()) return;
+    stopping_.store(true, std::memory_order_release);
+    wake_.notify_one();
+    writer_.join();
+    file_.close();
+}
+
+/**
+ * Function to queue a record for the writer thread.
+ * Claims a slot with a compare-and-swap on head_ (bounded MPMC queue with
+ * per-slot sequence numbers), so concurrent writers never take a lock.
+ * @param record The record to log.
+ */
+void GameLog::write(const LogRecord& record) {
+    if (!writer_.joinable()) return;
+
+    size_t position = head_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots_[position & mask_];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0) {
+            if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        } else if (difference < 0) {
+            // Ring is full: hurry the writer along and wait for a free slot
+            wake_.notify_one();
+            std::this_thread::yield();
+            position = head_.load(std::memory_order_relaxed);
+        } else {
+            position = head_.load(std::memory_order_relaxed);
+        }
+    }
+    slot->record = record;
+    slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+void GameLog::flush() {
+    if (!writer_.joinable()) return;
+
+    size_t target = head_.load(std::memory_order_acquire);
+    size_t request = flushRequest_.load(std::memory_order_relaxed);
+    while (request < target && !flushRequest_.compare_exchange_weak(request, target)) {
+    }
+    wake_.notify_one();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (written_.load(std::memory_order_acquire) < target) {
+        flushed_.wait_for(lock, kIdleWait);
+    }
+}
+
+// Takes the next record if its writer has finished copying it in.
+bool GameLog::pop(LogRecord& record) {
+    Slot& slot = slots_[tail_ & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1) return false;
+    record = slot.record;
+    slot.sequence.store(tail_ + mask_ + 1, std::memory_order_release);
+    ++tail_;
+    return true;
+}
+
+void GameLog::writeRecord(const LogRecord& record) {
+    if (format_ == LogFormat::Binary) {
+        file_.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        return;
+    }
+    file_ << "{\"game\":" << record.gameId << ",\"strategy\":";
+    writeJsonString(file_, record.strategy, sizeof(record.strategy));
+    if (record.kind == 'S') {
+        file_ << ",\"kind\":\"start\",\"word\":";
+        writeJsonString(file_, record.question, sizeof(record.question));
+        file_ << ",\"seed\":";
+        writeJsonHex(file_, record.seed);
+        file_ << ",\"dictionary\":";
+        writeJsonHex(file_, record.dictionary);
+        file_ << "}\n";
+        return;
+    }
+    if (record.kind == 'E') {
+        file_ << ",\"kind\":\"end\",\"result\":";
+        writeJsonString(file_, record.answer, sizeof(record.answer));
+        file_ << ",\"turns\":" << record.turn << "}\n";
+        return;
+    }
+    file_ << ",\"turn\":" << record.turn << ",\"kind\":\"" << (record.kind == 'W' ? "word" : "letter") << "\",\"question\":";
+    writeJsonString(file_, record.question, sizeof(record.question));
+    file_ << ",\"answer\":";
+    writeJsonString(file_, record.answer, sizeof(record.answer));
+    file_ << ",\"micros\":" << record.answerMicros << ",\"decision_micros\":" << record.decisionMicros << "}\n";
+}
+
+// Writer thread: drains the ring into the file buffer and flushes the file once the ring goes quiet.
+void GameLog::run() {
+    LogRecord record;
+    bool dirty = false;
+    while (true) {
+        size_t drained = 0;
+        while (pop(record)) {
+            writeRecord(record);
+            ++drained;
+        }
+        dirty = dirty || drained > 0;
+
+        // One flush per quiet spell, or straight away when flush() is waiting
+        if (dirty && (drained == 0 || flushRequest_.load(std::memory_order_relaxed) > written_.load(std::memory_order_relaxed))) {
+            file_.flush();
+            written_.store(tail_, std::memory_order_release);
+            flushed_.notify_all();
+            dirty = false;
+        }
+
+        bool stopping = stopping_.load(std::memory_order_acquire);
+        if (stopping && !dirty && head_.load(std::memory_order_acquire) == tail_) break;
+        if (stopping || flushRequest_.load(std::memory_order_relaxed) > tail_) {
+            std::this_thread::yield(); // a record is still being copied in
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait_for(lock, kIdleWait);
+    }
+}
+
+GameLog& defaultGameLog() {
+    static GameLog log;
+    static bool opened = log.open("knowsall_log.jsonl", LogFormat::Jsonl);
+    (void)opened;
+    return log;
+}
+
+/**
+ * Function to read a game log back.
+ * Binary logs must have been written with this record layout; JSONL logs of
+ * any version are read line by line, and lines that do not parse (such as a
+ * last line cut short by a crash) are skipped with a warning.
+ * @param filename The log file.
+ * @param records The records, appended in file order.
+ * @return True if the file was read, false if it cannot be opened or is a binary log of another layout.
+ */
+bool readGameLog(const std::string& filename, std::vector<LogRecord>& records) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open game log: " << filename << "\n";
+        return false;
+    }
+
+    LogHeader header;
+    std::memset(&header, 0, sizeof(header));
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (file.gcount() == sizeof(header) && std::memcmp(header.magic, kLogMagic, sizeof(kLogMagic)) == 0) {
+        if (header.version != kLogVersion || header.recordSize != sizeof(LogRecord)) {
+            std::cerr << "Error: " << filename << " is a version " << header.version << " binary log; this build reads version "
+                      << kLogVersion << "\n";
+            return false;
+        }
+        LogRecord record;
+        while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            records.push_back(record);
+        }
+        return true;
+    }
+
+    file.clear();
+    file.seekg(0);
+    std::string line;
+    size_t skipped = 0;
+    LogRecord record;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        if (parseJsonRecord(line, record)) {
+            records.push_back(record);
+        } else {
+            ++skipped;
+        }
+    }
+    if (skipped > 0) {
+        std::cerr << "Warning: Skipped " << skipped << " malformed line(s) in " << filename << "\n";
+    }
+    return true;
+}
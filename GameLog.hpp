@@ -0,0 +1,107 @@
+#ifndef GAME_LOG_HPP
+#define GAME_LOG_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * One entry of the game log: a game's start, one question and its answer, or
+ * the game's end. A game is logged as one 'S' record, its questions in order
+ * and one 'E' record, which is everything needed to replay it.
+ * Fixed size so it can sit in the ring buffer and be written as-is in the
+ * binary format; text fields are truncated and NUL-padded.
+ */
+struct LogRecord {
+    uint64_t gameId = 0;
+    uint64_t seed = 0;           // 'S': the seed of the game's random engine
+    uint64_t dictionary = 0;     // 'S': fingerprint of the dictionary the game was played on
+    uint32_t answerMicros = 0;   // time the player took to answer
+    uint32_t decisionMicros = 0; // time Knowsall took to pick the question
+    uint16_t turn = 0;           // 1-based question number within the game; for 'E' the questions put
+    char kind = 'L';             // 'S' game start, 'L' letter question, 'W' word question, 'E' game end
+    char reserved = 0;
+    char strategy[24] = {};
+    char question[32] = {};      // the letter or the word asked; for 'S' the secret word
+    char answer[12] = {};        // the raw response; for 'E' "win" or "lose"
+
+    static void setField(char* field, size_t size, std::string_view value);
+};
+
+enum class LogFormat {
+    Jsonl,  // one JSON object per line
+    Binary  // "KNOWSLOG" header, then raw LogRecords
+};
+
+/**
+ * Asynchronous game log.
+ * write() copies the record into a bounded lock-free ring buffer (several
+ * threads may write at once) and returns; a background thread drains the ring
+ * into a buffered file and flushes it whenever it runs dry. A full ring makes
+ * writers wait for space rather than drop records, so memory stays at the
+ * ring's capacity. Records still in the ring are written out by flush(),
+ * close() and the destructor, so a normal exit never loses any.
+ */
+class GameLog {
+public:
+    explicit GameLog(size_t capacity = 4096); // rounded up to a power of two
+    ~GameLog();
+
+    GameLog(const GameLog&) = delete;
+    GameLog& operator=(const GameLog&) = delete;
+
+    // Opens (appending to) the log file and starts the writer thread.
+    bool open(const std::string& filename, LogFormat format);
+    // Drains the ring, stops the writer and closes the file.
+    void close();
+    bool isOpen() const { return writer_.joinable(); }
+
+    // Queues a record; a no-op if the log is not open.
+    void write(const LogRecord& record);
+    // Returns once every record written before the call is in the file.
+    void flush();
+
+    // Records written to the file so far.
+    uint64_t recordsWritten() const { return written_.load(std::memory_order_acquire); }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+
+    bool pop(LogRecord& record);
+    void writeRecord(const LogRecord& record);
+    void run();
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> head_{0}; // next slot a writer claims
+    alignas(64) size_t tail_ = 0;             // next slot the writer thread reads
+
+    std::ofstream file_;
+    LogFormat format_ = LogFormat::Jsonl;
+    std::thread writer_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<size_t> flushRequest_{0}; // head_ value a flush() waits for
+    std::mutex mutex_;                    // only for sleeping, never on the write path
+    std::condition_variable wake_;
+    std::condition_variable flushed_;
+};
+
+// The log interactive games append to (knowsall_log.jsonl), opened on first use.
+GameLog& defaultGameLog();
+
+// Reads every record of a JSONL or binary game log, telling the two apart by the binary header.
+bool readGameLog(const std::string& filename, std::vector<LogRecord>& records);
+
+#endif // GAME_LOG_HPP
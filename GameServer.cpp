@@ -0,0 +1,251 @@
+#include "GameServer.hpp"
+#include "CommandLine.hpp"
+#include "Random.hpp"
+#include "Strategy.hpp"
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+GameServer::~GameServer() {
+    while (!sessions_.empty()) close(sessions_.begin()->first);
+    if (listenFd_ >= 0) {
+        loop_.unwatch(listenFd_);
+        ::close(listenFd_);
+    }
+    if (!unixPath_.empty()) unlink(unixPath_.c_str());
+    if (signalFd_ >= 0) {
+        loop_.unwatch(signalFd_);
+        ::close(signalFd_);
+    }
+}
+
+/**
+ * Function to open the listening socket.
+ * @param address A Unix-domain socket path, or "tcp:PORT" for the loopback interface.
+ * @return True if the server is listening, false otherwise.
+ */
+bool GameServer::listen(const std::string& address) {
+    if (!loop_.valid()) {
+        std::cerr << "Error: Could not create the event loop.\n";
+        return false;
+    }
+
+    uint16_t port = 0;
+    if (!parseAddress(address, port)) return false;
+    bool tcp = port != 0;
+    listenFd_ = socket(tcp ? AF_INET : AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0) {
+        std::cerr << "Error: Could not create a socket: " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    int bound;
+    if (tcp) {
+        int reuse = 1;
+        setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in in{};
+        in.sin_family = AF_INET;
+        in.sin_port = htons(port);
+        in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bound = bind(listenFd_, reinterpret_cast<sockaddr*>(&in), sizeof(in));
+    } else {
+        sockaddr_un un{};
+        un.sun_family = AF_UNIX;
+        if (address.size() >= sizeof(un.sun_path)) {
+            std::cerr << "Error: Socket path is too long: " << address << "\n";
+            return false;
+        }
+        std::memcpy(un.sun_path, address.c_str(), address.size() + 1);
+        unlink(address.c_str()); // a stale socket from an earlier run
+        bound = bind(listenFd_, reinterpret_cast<sockaddr*>(&un), sizeof(un));
+        if (bound == 0) unixPath_ = address;
+    }
+
+    if (bound != 0 || ::listen(listenFd_, SOMAXCONN) != 0) {
+        std::cerr << "Error: Could not listen on " << address << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+    return loop_.watch(listenFd_, [this]() { accept(); });
+}
+
+bool GameServer::stopOnSignals() {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    if (pthread_sigmask(SIG_BLOCK, &signals, nullptr) != 0) return false;
+    signalFd_ = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signalFd_ < 0) return false;
+    return loop_.watch(signalFd_, [this]() {
+        signalfd_siginfo info;
+        while (read(signalFd_, &info, sizeof(info)) == static_cast<ssize_t>(sizeof(info))) {
+        }
+        stop();
+    });
+}
+
+void GameServer::run() {
+    loop_.run();
+}
+
+void GameServer::accept() {
+    while (true) {
+        int fd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::cerr << "Warning: accept failed: " << std::strerror(errno) << "\n";
+            }
+            return;
+        }
+        if (!loop_.watch(fd, [this, fd]() { onReadable(fd); })) {
+            ::close(fd);
+            continue;
+        }
+        sessions_[fd] = std::make_unique<Session>(fd);
+    }
+}
+
+void GameServer::close(int fd) {
+    loop_.unwatch(fd);
+    sessions_.erase(fd);
+    ::close(fd);
+}
+
+void GameServer::onReadable(int fd) {
+    auto it = sessions_.find(fd);
+    if (it == sessions_.end()) return;
+    Session& session = *it->second;
+
+    bool open = session.reader.fill();
+    std::string line;
+    while (session.reader.nextLine(line)) {
+        if (!handle(session, line)) {
+            close(fd);
+            return;
+        }
+    }
+    if (!open) close(fd);
+}
+
+/**
+ * Function to send one reply line.
+ * Clients wait for each reply before sending again, so a reply always fits
+ * in the socket buffer; a client that lets it fill up is disconnected.
+ * @return True if the whole line was sent.
+ */
+bool GameServer::send(int fd, const std::string& line) {
+    std::string message = line + "\n";
+    ssize_t sent = ::send(fd, message.data(), message.size(), MSG_NOSIGNAL);
+    return sent == static_cast<ssize_t>(message.size());
+}
+
+bool GameServer::startGame(Session& session, const std::string& strategy, const std::string& word) {
+    const StrategyInfo* mode = findStrategy(strategy);
+    if (!mode) return send(session.reader.fd(), "error unknown strategy " + strategy);
+    std::shared_ptr<const DictionarySnapshot> snapshot = dictionary_.current();
+    const CandidateStore& store = snapshot->store();
+    size_t wordId = snapshot->index().find(word, true);
+    if (wordId == WordIndex::npos) return send(session.reader.fd(), "error word not in dictionary");
+
+    // The session's GameState is reused from game to game; the previous game and its snapshot are let go here
+    session.game = GameTask();
+    session.mode = mode;
+    session.secretWord = store.dictionary().word(wordId);
+    if (session.state) {
+        session.state->reset(store, word.length());
+    } else {
+        session.state = std::make_unique<GameState>(store, word.length());
+    }
+    reseedGameRng(); // randomized strategies draw everything they need while being built
+    session.strategy = mode->create(store, word.length());
+    session.snapshot = std::move(snapshot);
+    session.gameId = ++games_;
+    session.turn = 0;
+    if (gameLog_) log(session, gameStartRecord(session.secretWord, gameSeed(), store.dictionary().fingerprint()));
+    session.game = gameLoop(*session.strategy, mode->rules, session.secretWord, *session.state, discard_);
+    advance(session, nullptr);
+    return sendQuestionOrResult(session);
+}
+
+void GameServer::advance(Session& session, const std::string* response) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    if (response) {
+        if (gameLog_) {
+            ++session.turn;
+            log(session, questionRecord(session.game.question(), *response, session.turn, start - session.askedAt,
+                                        session.decisionTime));
+        }
+        session.game.resume(*response);
+    } else {
+        session.game.start();
+    }
+    session.askedAt = Clock::now();
+    session.decisionTime = session.askedAt - start;
+    if (gameLog_ && session.game.finished()) log(session, gameEndRecord(session.game.result().won, session.turn));
+}
+
+void GameServer::log(const Session& session, LogRecord record) {
+    record.gameId = session.gameId;
+    LogRecord::setField(record.strategy, sizeof(record.strategy), session.mode->name);
+    gameLog_->write(record);
+}
+
+bool GameServer::sendQuestionOrResult(Session& session) {
+    const GameTask& game = session.game;
+    if (game.finished()) {
+        const GameResult& result = game.result();
+        return send(session.reader.fd(), std::string("done ") + (result.won ? "win " : "lose ") + std::to_string(result.questionsAsked));
+    }
+    const Question& question = game.question();
+    if (question.kind == Question::Kind::Letter) {
+        return send(session.reader.fd(), std::string("ask letter ") + question.letter);
+    }
+    return send(session.reader.fd(), "ask word " + std::string(question.word));
+}
+
+bool GameServer::handle(Session& session, const std::string& line) {
+    std::istringstream words(line);
+    std::string command;
+    words >> command;
+
+    if (command == "quit") return false;
+    if (command == "stats") {
+        std::shared_ptr<const DictionarySnapshot> snapshot = dictionary_.current();
+        QuestionCache::Stats cache = snapshot->questionCache().stats();
+        std::ostringstream reply;
+        reply << "stats sessions " << sessions_.size() << " dictionary " << snapshot->version() << " cache-hits " << cache.hits
+              << " cache-misses " << cache.misses << " cache-evictions " << cache.evictions << " cache-hit-rate " << std::fixed
+              << std::setprecision(3) << cache.hitRate();
+        return send(session.reader.fd(), reply.str());
+    }
+    if (command == "new") {
+        std::string strategy, word;
+        words >> strategy >> word;
+        if (word.empty()) return send(session.reader.fd(), "error usage: new STRATEGY WORD");
+        return startGame(session, strategy, word);
+    }
+    // Only real answers reach the game; anything else would be taken as "no"
+    if (command != "yes" && command != "no" && command != "undo") {
+        return send(session.reader.fd(), "error unknown command");
+    }
+    if (!session.game.valid() || session.game.finished()) {
+        return send(session.reader.fd(), "error no game in progress");
+    }
+    // The engine would take an undo it does not allow as an invalid answer and use up the letter
+    if (command == "undo" && !session.mode->rules.allowUndo) {
+        return send(session.reader.fd(), "error undo not allowed in this mode");
+    }
+    advance(session, &command);
+    return sendQuestionOrResult(session);
+}
@@ -0,0 +1,97 @@
+#ifndef GAME_SERVER_HPP
+#define GAME_SERVER_HPP
+
+#include "DictionarySnapshot.hpp"
+#include "EventLoop.hpp"
+#include "GameEngine.hpp"
+#include "GameLog.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Hosts Knowsall games for many clients at once on one thread.
+ * Every connection is a session with its own small game state; all sessions
+ * share the read-only dictionary snapshot. Games are coroutines parked between
+ * answers, so the event loop only does work when a client has sent a line.
+ * When the dictionary is reloaded, games in progress finish on the snapshot
+ * they started with and the next "new" uses the new one.
+ *
+ * Protocol (one line per message; the client always waits for the reply):
+ *   client: new STRATEGY WORD    server: ask letter C | ask word W | done ...
+ *   client: yes | no | undo      server: ask ... | done win|lose QUESTIONS (undo only where the mode allows it)
+ *   client: stats                server: stats sessions N dictionary VERSION cache-hits N ...
+ *   client: quit                 (closes the session)
+ * WORD may use any capitalisation. Anything else is answered with
+ * "error MESSAGE". The client states its word up front because, as in the
+ * terminal game, Knowsall needs it to reveal letter positions; it never uses
+ * it to choose questions.
+ *
+ * With a game log, every game is logged like a batch game (start, each
+ * question with the client's answer time, end), so it can be replayed.
+ */
+class GameServer {
+public:
+    explicit GameServer(const DictionaryWatcher& dictionary, GameLog* gameLog = nullptr)
+        : dictionary_(dictionary), gameLog_(gameLog), discard_(nullptr) {}
+    ~GameServer();
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    // Listens on a Unix-domain socket path, or on 127.0.0.1 for "tcp:PORT".
+    bool listen(const std::string& address);
+    // Makes SIGINT and SIGTERM stop the server, so run() returns and everything is cleaned up.
+    // The signals are blocked in the calling thread; call it before starting other threads.
+    bool stopOnSignals();
+    // Serves clients until stop() is called.
+    void run();
+    void stop() { loop_.stop(); }
+
+    size_t sessions() const { return sessions_.size(); }
+
+private:
+    struct Session {
+        explicit Session(int fd) : reader(fd) {}
+
+        InputReader reader;
+        std::shared_ptr<const DictionarySnapshot> snapshot; // declared first so it outlives the game using it
+        std::string secretWord;
+        std::unique_ptr<GameState> state;
+        std::unique_ptr<Strategy> strategy;
+        GameTask game;
+        const StrategyInfo* mode = nullptr;
+        // For the game log
+        uint64_t gameId = 0;
+        int turn = 0;
+        std::chrono::steady_clock::time_point askedAt;      // when the pending question was sent
+        std::chrono::steady_clock::duration decisionTime{}; // how long picking it took
+    };
+
+    void accept();
+    void onReadable(int fd);
+    // Handles one line; returns false if the session should be closed.
+    bool handle(Session& session, const std::string& line);
+    bool startGame(Session& session, const std::string& strategy, const std::string& word);
+    bool sendQuestionOrResult(Session& session);
+    // Runs the game up to its next question (start or resume), timing it for the log.
+    void advance(Session& session, const std::string* response);
+    void log(const Session& session, LogRecord record);
+    bool send(int fd, const std::string& line);
+    void close(int fd);
+
+    const DictionaryWatcher& dictionary_;
+    GameLog* gameLog_;    // nullptr when games are not logged
+    uint64_t games_ = 0;  // games started, numbering them in the log
+    EventLoop loop_;
+    int listenFd_ = -1;
+    int signalFd_ = -1;
+    std::string unixPath_; // removed again on shutdown
+    std::ostream discard_; // engine messages meant for a terminal are dropped
+    std::unordered_map<int, std::unique_ptr<Session>> sessions_;
+};
+
+#endif // GAME_SERVER_HPP
@@ -0,0 +1,113 @@
+#include "GameState.hpp"
+#include "Profile.hpp"
+
+/**
+ * Starts a game for a secret word of the given length.
+ * @param store The dictionary index.
+ * @param length The length of the secret word.
+ */
+GameState::GameState(const CandidateStore& store, size_t length) : candidates_(store, length), pattern_(length, '_') {
+    checkpoints_.reserve(kLetterSlots); // a game asks each letter at most once
+}
+
+/**
+ * Starts a new game, keeping the bitset and history memory of the previous
+ * one, so a reused state plays without allocating once it has grown to fit.
+ * @param store The dictionary index.
+ * @param length The length of the secret word.
+ */
+void GameState::reset(const CandidateStore& store, size_t length) {
+    candidates_.reset(store, length);
+    pattern_.assign(length, '_');
+    guessedLetters_ = 0;
+    changes_.clear();
+    checkpoints_.clear();
+    applied_ = 0;
+    countsValid_ = false;
+}
+
+/**
+ * Applies an answer to the pattern, the asked letters and the candidates.
+ * @param answer The letter asked and the positions it was found at.
+ */
+void GameState::apply(const LetterAnswer& answer) {
+    PROFILE_SCOPE(Filter);
+
+    // A new answer forks history: drop whatever could have been redone
+    if (applied_ < checkpoints_.size()) {
+        changes_.resize(applied_ ? checkpoints_[applied_ - 1].changesEnd : 0);
+        checkpoints_.resize(applied_);
+    }
+
+    uint32_t bit = letterSlot(answer.letter) < kAlphabetSize ? uint32_t{1} << letterSlot(answer.letter) : 0;
+    uint64_t hidden = 0;
+    for (size_t i = 0; i < pattern_.length() && i < 64; ++i) {
+        if (pattern_[i] == '_') hidden |= uint64_t{1} << i;
+    }
+    Checkpoint checkpoint{answer, answer.positions & hidden, changes_.size(), 0,
+                          candidates_.narrowed(), (guessedLetters_ & bit) != 0};
+
+    fill(checkpoint.revealed, answer.letter);
+    guessedLetters_ |= bit;
+    candidates_.applyAnswer(answer.letter, pattern_, &changes_);
+
+    checkpoint.changesEnd = changes_.size();
+    checkpoints_.push_back(checkpoint);
+    ++applied_;
+    countsValid_ = false;
+}
+
+bool GameState::undo() {
+    if (applied_ == 0) return false;
+    const Checkpoint& checkpoint = checkpoints_[--applied_];
+
+    candidates_.undoChanges(changes_.data() + checkpoint.changesBegin, changes_.data() + checkpoint.changesEnd,
+                            checkpoint.wasNarrowed);
+    fill(checkpoint.revealed, '_');
+    if (!checkpoint.wasGuessed && letterSlot(checkpoint.answer.letter) < kAlphabetSize) {
+        guessedLetters_ &= ~(uint32_t{1} << letterSlot(checkpoint.answer.letter));
+    }
+    countsValid_ = false;
+    return true;
+}
+
+bool GameState::redo() {
+    if (applied_ == checkpoints_.size()) return false;
+    const Checkpoint& checkpoint = checkpoints_[applied_++];
+
+    candidates_.redoChanges(changes_.data() + checkpoint.changesBegin, changes_.data() + checkpoint.changesEnd);
+    fill(checkpoint.revealed, checkpoint.answer.letter);
+    if (letterSlot(checkpoint.answer.letter) < kAlphabetSize) {
+        guessedLetters_ |= uint32_t{1} << letterSlot(checkpoint.answer.letter);
+    }
+    countsValid_ = false;
+    return true;
+}
+
+const LetterHistogram& GameState::letterCounts() const {
+    if (!countsValid_) {
+        letterCounts_ = candidates_.letterCounts(guessedLetters_);
+        countsValid_ = true;
+    }
+    return letterCounts_;
+}
+
+void GameState::setLetterCounts(const LetterHistogram& counts) {
+    letterCounts_ = counts;
+    countsValid_ = true;
+}
+
+LetterAnswer GameState::answerFor(const std::string& secretWord, char letter) {
+    LetterAnswer answer{letter, 0};
+    for (size_t i = 0; i < secretWord.length() && i < 64; ++i) {
+        if (secretWord[i] == letter) answer.positions |= uint64_t{1} << i;
+    }
+    return answer;
+}
+
+// Writes c at every position in the mask.
+void GameState::fill(uint64_t positions, char c) {
+    for (size_t i = 0; i < pattern_.length() && i < 64; ++i) {
+        if (positions & (uint64_t{1} << i)) pattern_[i] = c;
+    }
+}
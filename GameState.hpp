@@ -0,0 +1,77 @@
+#ifndef GAME_STATE_HPP
+#define GAME_STATE_HPP
+
+#include "CandidateStore.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * An answer to "Is the letter X in your word?": the letter and the
+ * positions it occupies (no positions means "no").
+ */
+struct LetterAnswer {
+    char letter = '\0';
+    uint64_t positions = 0; // bit i set if the letter is at position i
+};
+
+/**
+ * Everything a letter-guessing game knows: the revealed pattern, the letters
+ * asked so far and the candidates still consistent with both.
+ * Answers narrow the candidate bitset in place and record only the blocks
+ * they changed, so undo and redo cost O(changed) instead of a re-filter.
+ * That makes corrected answers and what-if lookahead (apply, inspect, undo)
+ * cheap. The object is reusable across games via reset().
+ */
+class GameState {
+public:
+    GameState(const CandidateStore& store, size_t length);
+
+    // Starts a new game, keeping the memory of the previous one.
+    void reset(const CandidateStore& store, size_t length);
+
+    // Applies an answer; any undone answers can no longer be redone.
+    void apply(const LetterAnswer& answer);
+    // Takes back the last applied answer. Returns false if there is none.
+    bool undo();
+    // Re-applies the last undone answer. Returns false if there is none.
+    bool redo();
+
+    const std::string& pattern() const { return pattern_; }
+    uint32_t guessedLetters() const { return guessedLetters_; }
+    const CandidateSet& candidates() const { return candidates_; }
+    size_t answers() const { return applied_; }
+    bool solved() const { return pattern_.find('_') == std::string::npos; }
+
+    // Candidates containing each letter not asked yet; computed on first use and kept until the state changes.
+    const LetterHistogram& letterCounts() const;
+    // Supplies the counts from outside, e.g. computed for many games in one pass.
+    void setLetterCounts(const LetterHistogram& counts);
+    bool hasLetterCounts() const { return countsValid_; }
+
+    // The answer the given secret word would give about a letter.
+    static LetterAnswer answerFor(const std::string& secretWord, char letter);
+
+private:
+    struct Checkpoint {
+        LetterAnswer answer;
+        uint64_t revealed;   // positions this answer uncovered
+        size_t changesBegin; // first BlockChange recorded by this answer
+        size_t changesEnd;
+        bool wasNarrowed;    // candidates_.narrowed() before the answer
+        bool wasGuessed;     // letter already asked before the answer
+    };
+
+    void fill(uint64_t positions, char c);
+
+    CandidateSet candidates_;
+    std::string pattern_;
+    uint32_t guessedLetters_ = 0;
+    std::vector<CandidateSet::BlockChange> changes_;
+    std::vector<Checkpoint> checkpoints_; // [0, applied_) applied, the rest can be redone
+    size_t applied_ = 0;
+    mutable LetterHistogram letterCounts_{};
+    mutable bool countsValid_ = false;
+};
+
+#endif // GAME_STATE_HPP
@@ -0,0 +1,120 @@
+#ifndef GAME_TASK_HPP
+#define GAME_TASK_HPP
+
+#include "GameArena.hpp"
+#include "GameIO.hpp"
+#include <coroutine>
+#include <string>
+#include <utility>
+
+/**
+ * How a game ended.
+ */
+struct GameResult {
+    bool won = false;
+    int questionsAsked = 0;
+};
+
+/**
+ * A game running as a coroutine.
+ * The game suspends with `std::string response = co_yield question;` and
+ * sleeps until whoever drives it calls resume() with the answer, so a
+ * terminal, the headless oracle or a network session can all drive the same
+ * game code, and any number of games can wait at once without a thread each.
+ * The coroutine starts suspended; start() runs it to its first question.
+ *
+ * A driver advancing many games together can also ask each game to stop
+ * just before it picks a question (pauseBeforeQuestions), prepare shared
+ * work for all of them, and let each continue with proceed().
+ *
+ * Frames come from the thread's GameArena, so starting a game reuses the
+ * frame of an earlier one instead of calling the heap; a task must be
+ * destroyed on the thread that created it.
+ */
+class GameTask {
+public:
+    // co_await'ed by the game right before it picks each question.
+    struct BeforeQuestion {};
+
+    struct promise_type {
+        Question question;
+        std::string response;
+        GameResult result;
+        bool pauseBeforeQuestions = false;
+        bool choosing = false; // suspended at BeforeQuestion rather than on a question
+
+        // Hands the answer back as the value of the co_yield expression.
+        struct ResponseAwaiter {
+            promise_type& promise;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<>) const noexcept {}
+            std::string await_resume() const { return std::move(promise.response); }
+        };
+
+        // Suspends at BeforeQuestion only when the driver asked for it.
+        struct ChooseAwaiter {
+            promise_type& promise;
+            bool await_ready() const noexcept { return !promise.pauseBeforeQuestions; }
+            void await_suspend(std::coroutine_handle<>) const noexcept { promise.choosing = true; }
+            void await_resume() const noexcept { promise.choosing = false; }
+        };
+
+        static void* operator new(size_t bytes) { return threadArena().allocate(bytes); }
+        static void operator delete(void* frame, size_t bytes) { threadArena().release(frame, bytes); }
+
+        GameTask get_return_object() { return GameTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        ResponseAwaiter yield_value(const Question& asked) {
+            question = asked;
+            return ResponseAwaiter{*this};
+        }
+        ChooseAwaiter await_transform(BeforeQuestion) { return ChooseAwaiter{*this}; }
+        void return_value(GameResult finalResult) { result = finalResult; }
+        void unhandled_exception() { throw; }
+    };
+
+    GameTask() = default;
+    GameTask(GameTask&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    GameTask& operator=(GameTask&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    GameTask(const GameTask&) = delete;
+    GameTask& operator=(const GameTask&) = delete;
+    ~GameTask() {
+        if (handle_) handle_.destroy();
+    }
+
+    bool valid() const { return static_cast<bool>(handle_); }
+
+    // Makes the game stop before picking each question; call before start().
+    void pauseBeforeQuestions() { handle_.promise().pauseBeforeQuestions = true; }
+
+    // Runs the game up to its first question (or its end).
+    void start() { handle_.resume(); }
+    bool finished() const { return handle_.done(); }
+    // True while the game is stopped before picking a question.
+    bool choosing() const { return !handle_.done() && handle_.promise().choosing; }
+    // Lets a choosing() game pick its question and run up to it (or its end).
+    void proceed() { handle_.resume(); }
+    // The question waiting for an answer; only meaningful while !finished() && !choosing().
+    const Question& question() const { return handle_.promise().question; }
+    // Answers question() and runs the game up to its next question (or its end).
+    void resume(std::string response) {
+        handle_.promise().response = std::move(response);
+        handle_.resume();
+    }
+    // How the game ended; only meaningful once finished().
+    const GameResult& result() const { return handle_.promise().result; }
+
+private:
+    explicit GameTask(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+#endif // GAME_TASK_HPP
@@ -1,657 +1,34 @@
 #include "Knowsall.hpp"
+#include "DictionarySnapshot.hpp"
+#include "GameIO.hpp"
+#include "Strategy.hpp"
+#include "Batch.hpp"
+#include "CommandLine.hpp"
+#include "GameServer.hpp"
+#include "Profile.hpp"
+#include "Random.hpp"
+#include "Replay.hpp"
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
-#include <ctime>
-#include <unordered_set>
 #include <algorithm>
-#include <map>
-#include <chrono>
-#include <thread>
-#include <random> // For std::shuffle
-
-// Function prototype for filterWords
-std::vector<std::string> filterWords(const std::vector<std::string>& dictionary, const std::string& guessedWord, const std::unordered_set<char>& guessedLetters);
-
-/**
- * Function to load the dictionary from a file.
- * @param filename The name of the dictionary file.
- * @param dictionary A vector to store the loaded words.
- * @return True if the file was loaded successfully, false otherwise.
- */
-bool loadDictionary(const std::string& filename, std::vector<std::string>& dictionary) {
-    std::ifstream file(filename); // Fixed: Corrected the file stream declaration
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open dictionary file: " << filename << "\n";
-        return false;
-    }
-
-    std::string word;
-    while (std::getline(file, word)) {
-        dictionary.push_back(word);
-    }
-
-    file.close();
-    return true;
-}
-
-/**
- * Function to filter the dictionary based on the current guessed word pattern.
- * @param dictionary The list of possible words.
- * @param guessedWord The current state of the guessed word (e.g., "_p_l_").
- * @param guessedLetters The set of letters that have already been guessed.
- * @return A filtered list of words that match the pattern.
- */
-std::vector<std::string> filterWords(const std::vector<std::string>& dictionary, const std::string& guessedWord, const std::unordered_set<char>& guessedLetters) {
-    std::vector<std::string> filteredWords;
-
-    for (const auto& word : dictionary) {
-        if (word.length() != guessedWord.length()) continue;
-
-        bool matches = true;
-        for (size_t i = 0; i < word.length(); ++i) {
-            if (guessedWord[i] != '_' && guessedWord[i] != word[i]) {
-                matches = false;
-                break;
-            }
-            if (guessedWord[i] == '_' && guessedLetters.find(word[i]) != guessedLetters.end()) {
-                matches = false;
-                break;
-            }
-        }
-
-        if (matches) {
-            filteredWords.push_back(word);
-        }
-    }
-
-    return filteredWords;
-}
-
-/**
- * Function to calculate the frequency of each letter in the remaining possible words.
- * @param possibleWords The list of possible words.
- * @param guessedLetters The set of letters that have already been guessed.
- * @return A map of letter frequencies.
- */
-std::map<char, int> calculateLetterFrequencies(const std::vector<std::string>& possibleWords, const std::unordered_set<char>& guessedLetters) {
-    std::map<char, int> letterFrequencies;
-
-    for (const auto& word : possibleWords) {
-        for (char letter : word) {
-            if (guessedLetters.find(letter) == guessedLetters.end()) {
-                letterFrequencies[letter]++;
-            }
-        }
-    }
-
-    return letterFrequencies;
-}
-
-/**
- * Function to log guesses and responses
- * @param guessedLetterOrWord The guessed letter or word.
- * @param response The user's response.
- */
-void logGuess(const std::string& guessedLetterOrWord, const std::string& response) {
-    std::ofstream logFile("knowsall_log.txt", std::ios::app);
-    if (logFile.is_open()) {
-        logFile << "Guess: " << guessedLetterOrWord << ", Response: " << response << "\n";
-        logFile.close();
-    }
-}
-
-/**
- * Function to display the guessed word with better formatting
- * @param guessedWord The current state of the guessed word.
- */
-void displayGuessedWord(const std::string& guessedWord) {
-    std::cout << "\nCurrent Word: ";
-    for (char c : guessedWord) {
-        std::cout << (c == '_' ? "_ " : std::string(1, c) + " ");
-    }
-    std::cout << "\n";
-}
-
-/**
- * Function to add a timer for user responses
- * @param response The user's response.
- * @param timeLimitSeconds The time limit in seconds.
- * @return True if the user responded within the time limit, false otherwise.
- */
-bool getUserResponseWithTimer(std::string& response, int timeLimitSeconds) {
-    auto start = std::chrono::steady_clock::now();
-    while (true) {
-        if (std::cin.peek() != EOF) {
-            std::cin >> response;
-            return true;
-        }
-        auto now = std::chrono::steady_clock::now();
-        if (std::chrono::duration_cast<std::chrono::seconds>(now - start).count() >= timeLimitSeconds) {
-            std::cout << "\nTime's up! Proceeding automatically...\n";
-            response = "no"; // Default response if time runs out
-            return false;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
-}
-
-/**
- * Letter-by-letter guessing mode.
- * Knowsall guesses letters sequentially and updates the guessed word.
- */
-void letterByLetterGuessing(const std::string& secretWord, const std::vector<std::string>& dictionary) {
-    std::unordered_set<char> guessedLetters;
-    std::string guessedWord(secretWord.length(), '_');
-    int maxQuestions = 20, questionsAsked = 0;
-
-    std::cout << "\nKnowsall will guess your word letter by letter.\n";
-
-    while (questionsAsked < maxQuestions && guessedWord != secretWord) {
-        char guessedLetter = 'a' + (questionsAsked % 26); // Sequential guessing
-        std::cout << "Is the letter '" << guessedLetter << "' in your word? (yes/no): ";
-        std::string response;
-        std::cin >> response;
-
-        // Handle invalid responses
-        if (response != "yes" && response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue; // Skip to the next iteration
-        }
-
-        if (response == "yes") {
-            for (size_t i = 0; i < secretWord.length(); ++i) {
-                if (secretWord[i] == guessedLetter) {
-                    guessedWord[i] = guessedLetter;
-                }
-            }
-            std::cout << "Updated word: " << guessedWord << "\n";
-        } else if (response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue;
-        }
-
-        ++questionsAsked;
-        std::cout << "Questions remaining: " << (maxQuestions - questionsAsked) << "\n";
-    }
-
-    if (guessedWord == secretWord) {
-        std::cout << "Knowsall guessed your word: " << secretWord << "\n";
-    } else {
-        std::cout << "Knowsall couldn't guess your word within " << maxQuestions << " questions.\n";
-    }
-}
-
-/**
- * Randomized Letter-by-Letter Guessing Mode.
- * Knowsall guesses letters in a random order and updates the guessed word.
- */
-void randomizedLetterByLetterGuessing(const std::string& secretWord, const std::vector<std::string>& dictionary) {
-    std::unordered_set<char> guessedLetters;
-    std::string guessedWord(secretWord.length(), '_');
-    int maxQuestions = 20, questionsAsked = 0;
-
-    // Create a shuffled alphabet
-    std::string alphabet = "abcdefghijklmnopqrstuvwxyz";
-    std::random_device rd;
-    std::mt19937 g(rd());
-    std::shuffle(alphabet.begin(), alphabet.end(), g);
-
-    std::cout << "\nKnowsall will guess your word letter by letter in random order.\n";
-
-    while (questionsAsked < maxQuestions && guessedWord != secretWord) {
-        char guessedLetter = '\0';
-
-        // Find the next unguessed letter
-        for (char letter : alphabet) {
-            if (guessedLetters.find(letter) == guessedLetters.end()) {
-                guessedLetter = letter;
-                guessedLetters.insert(letter);
-                break;
-            }
-        }
-
-        if (guessedLetter == '\0') {
-            std::cout << "Knowsall has run out of letters to guess.\n";
-            break;
-        }
-
-        std::cout << "Is the letter '" << guessedLetter << "' in your word? (yes/no): ";
-        std::string response;
-        std::cin >> response;
-
-        // Handle invalid responses
-        if (response != "yes" && response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue; // Skip to the next iteration
-        }
-
-        if (response == "yes") {
-            for (size_t i = 0; i < secretWord.length(); ++i) {
-                if (secretWord[i] == guessedLetter) {
-                    guessedWord[i] = guessedLetter;
-                }
-            }
-            std::cout << "Updated word: " << guessedWord << "\n";
-        } else if (response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue;
-        }
-
-        ++questionsAsked;
-        std::cout << "Questions remaining: " << (maxQuestions - questionsAsked) << "\n";
-    }
-
-    if (guessedWord == secretWord) {
-        std::cout << "Knowsall guessed your word: " << secretWord << "\n";
-    } else {
-        std::cout << "Knowsall couldn't guess your word within " << maxQuestions << " questions.\n";
-    }
-}
-
-/**
- * Word-by-word guessing mode.
- * Knowsall guesses entire words from the dictionary.
- */
-void wordByWordGuessing(const std::string& secretWord, const std::vector<std::string>& dictionary) {
-    int maxQuestions = 20, questionsAsked = 0;
-
-    std::cout << "\nKnowsall will guess your word word by word.\n";
-
-    for (const auto& word : dictionary) {
-        if (questionsAsked >= maxQuestions) break;
-
-        std::cout << "Is your word '" << word << "'? (yes/no): ";
-        std::string response;
-        std::cin >> response;
-
-        // Handle invalid responses
-        if (response != "yes" && response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue; // Skip to the next iteration
-        }
-
-        if (response == "yes") {
-            std::cout << "Knowsall guessed your word: " << word << "\n";
-            return;
-        } else if (response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue;
-        }
-
-        ++questionsAsked;
-    }
-
-    std::cout << "Knowsall couldn't guess your word within " << maxQuestions << " questions.\n";
-}
-
-/**
- * Randomized Word-by-Word Guessing Mode.
- * Knowsall guesses entire words in random order from the dictionary.
- */
-void randomizedWordByWordGuessing(const std::string& secretWord, std::vector<std::string> dictionary) {
-    int maxQuestions = 20, questionsAsked = 0;
-
-    // Shuffle the dictionary
-    std::random_device rd;
-    std::mt19937 g(rd());
-    std::shuffle(dictionary.begin(), dictionary.end(), g);
-
-    std::cout << "\nKnowsall will guess your word word by word in random order.\n";
-
-    for (const auto& word : dictionary) {
-        if (questionsAsked >= maxQuestions) break;
-
-        std::cout << "Is your word '" << word << "'? (yes/no): ";
-        std::string response;
-        std::cin >> response;
-
-        // Handle invalid responses
-        if (response != "yes" && response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue; // Skip to the next iteration
-        }
-
-        if (response == "yes") {
-            std::cout << "Knowsall guessed your word: " << word << "\n";
-            return;
-        } else if (response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue;
-        }
-
-        ++questionsAsked;
-    }
-
-    std::cout << "Knowsall couldn't guess your word within " << maxQuestions << " questions.\n";
-}
-
-/**
- * Frequency-based guessing mode.
- * Knowsall guesses letters based on their frequency in the English language.
- */
-void frequencyBasedGuessing(const std::string& secretWord, const std::vector<std::string>& dictionary) {
-    std::unordered_set<char> guessedLetters;
-    std::string guessedWord(secretWord.length(), '_');
-    int maxQuestions = 20, questionsAsked = 0;
-    std::string letterFrequency = "etaoinshrdlcumwfgypbvkjxqz";
-
-    std::cout << "\nKnowsall will guess your word based on letter frequency.\n";
-
-    while (questionsAsked < maxQuestions && guessedWord != secretWord) {
-        char guessedLetter = '\0';
-        for (char letter : letterFrequency) {
-            if (guessedLetters.find(letter) == guessedLetters.end()) {
-                guessedLetter = letter;
-                guessedLetters.insert(letter);
-                break;
-            }
-        }
-
-        if (guessedLetter == '\0') break;
-
-        std::cout << "Is the letter '" << guessedLetter << "' in your word? (yes/no): ";
-        std::string response;
-        std::cin >> response;
-
-        // Handle invalid responses
-        if (response != "yes" && response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue; // Skip to the next iteration
-        }
-
-        if (response == "yes") {
-            for (size_t i = 0; i < secretWord.length(); ++i) {
-                if (secretWord[i] == guessedLetter) {
-                    guessedWord[i] = guessedLetter;
-                }
-            }
-            std::cout << "Updated word: " << guessedWord << "\n";
-        } else if (response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue;
-        }
-
-        ++questionsAsked;
-        std::cout << "Questions remaining: " << (maxQuestions - questionsAsked) << "\n";
-    }
-
-    if (guessedWord == secretWord) {
-        std::cout << "Knowsall guessed your word: " << secretWord << "\n";
-    } else {
-        std::cout << "Knowsall couldn't guess your word within " << maxQuestions << " questions.\n";
-    }
-}
-
-/**
- * Random word guessing mode.
- * Knowsall guesses random words from the dictionary.
- */
-void randomWordGuessing(const std::string& secretWord, const std::vector<std::string>& dictionary) {
-    int maxQuestions = 20, questionsAsked = 0;
-    std::srand(std::time(nullptr));
-
-    std::cout << "\nKnowsall will guess random words from the dictionary.\n";
-
-    while (questionsAsked < maxQuestions) {
-        std::string guessedWord = dictionary[std::rand() % dictionary.size()];
-        std::cout << "Is your word '" << guessedWord << "'? (yes/no): ";
-        std::string response;
-        std::cin >> response;
-
-        // Handle invalid responses
-        if (response != "yes" && response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue; // Skip to the next iteration
-        }
-
-        if (response == "yes") {
-            std::cout << "Knowsall guessed your word: " << guessedWord << "\n";
-            return;
-        } else if (response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue;
-        }
-
-        ++questionsAsked;
-    }
-
-    std::cout << "Knowsall couldn't guess your word within " << maxQuestions << " questions.\n";
-}
-
-/**
- * AI-based guessing mode.
- * Knowsall uses pattern matching and letter frequency analysis to guess the word.
- */
-void aiGuessing(const std::string& secretWord, const std::vector<std::string>& dictionary) {
-    std::unordered_set<char> guessedLetters;
-    std::string guessedWord(secretWord.length(), '_');
-    int maxQuestions = 20, questionsAsked = 0;
-
-    std::cout << "\nKnowsall will guess your word using AI-like features.\n";
-
-    std::vector<std::string> possibleWords = dictionary;
-
-    while (questionsAsked < maxQuestions && guessedWord != secretWord) {
-        // Filter the dictionary based on the current guessed word pattern
-        possibleWords = filterWords(possibleWords, guessedWord, guessedLetters);
-
-        if (possibleWords.empty()) {
-            std::cout << "Knowsall has no more possible words to guess.\n";
-            break;
-        }
-
-        // Calculate letter frequencies in the remaining possible words
-        auto letterFrequencies = calculateLetterFrequencies(possibleWords, guessedLetters);
-
-        // Find the most frequent letter
-        char guessedLetter = '\0';
-        int maxFrequency = 0;
-        for (const auto& pair : letterFrequencies) {
-            char letter = pair.first;
-            int frequency = pair.second;
-            if (frequency > maxFrequency) {
-                guessedLetter = letter;
-                maxFrequency = frequency;
-            }
-        }
-
-        if (guessedLetter == '\0') {
-            std::cout << "Knowsall has run out of letters to guess.\n";
-            break;
-        }
-
-        guessedLetters.insert(guessedLetter);
-
-        std::cout << "Is the letter '" << guessedLetter << "' in your word? (yes/no): ";
-        std::string response;
-        std::cin >> response;
-
-        // Handle invalid responses
-        if (response != "yes" && response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue; // Skip to the next iteration
-        }
-
-        if (response == "yes") {
-            for (size_t i = 0; i < secretWord.length(); ++i) {
-                if (secretWord[i] == guessedLetter) {
-                    guessedWord[i] = guessedLetter;
-                }
-            }
-            std::cout << "Updated word: " << guessedWord << "\n";
-        } else if (response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue;
-        }
-
-        ++questionsAsked;
-        std::cout << "Questions remaining: " << (maxQuestions - questionsAsked) << "\n";
-    }
-
-    if (guessedWord == secretWord) {
-        std::cout << "Knowsall guessed your word: " << secretWord << "\n";
-    } else {
-        std::cout << "Knowsall couldn't guess your word within " << maxQuestions << " questions.\n";
-    }
-}
-
-/**
- * AI-based guessing mode with enhancements.
- * Knowsall uses pattern matching, letter frequency analysis, logging, and a timer to guess the word.
- */
-void aiGuessingWithEnhancements(const std::string& secretWord, const std::vector<std::string>& dictionary) {
-    std::unordered_set<char> guessedLetters;
-    std::string guessedWord(secretWord.length(), '_');
-    int maxQuestions = 20, questionsAsked = 0;
-
-    std::cout << "\nKnowsall will guess your word using AI-like features.\n";
-
-    std::vector<std::string> possibleWords = dictionary;
-
-    while (questionsAsked < maxQuestions && guessedWord != secretWord) {
-        // Filter the dictionary based on the current guessed word pattern
-        possibleWords = filterWords(possibleWords, guessedWord, guessedLetters);
-
-        if (possibleWords.empty()) {
-            std::cout << "Knowsall has no more possible words to guess.\n";
-            break;
-        }
-
-        // Calculate letter frequencies in the remaining possible words
-        auto letterFrequencies = calculateLetterFrequencies(possibleWords, guessedLetters);
-
-        // Find the most frequent letter
-        char guessedLetter = '\0';
-        int maxFrequency = 0;
-        for (const auto& pair : letterFrequencies) {
-            char letter = pair.first;
-            int frequency = pair.second;
-            if (frequency > maxFrequency) {
-                guessedLetter = letter;
-                maxFrequency = frequency;
-            }
-        }
-
-        if (guessedLetter == '\0') {
-            std::cout << "Knowsall has run out of letters to guess.\n";
-            break;
-        }
-
-        guessedLetters.insert(guessedLetter);
-
-        std::cout << "Is the letter '" << guessedLetter << "' in your word? (yes/no): ";
-        std::string response;
-        getUserResponseWithTimer(response, 10); // 10-second timer for user response
-
-        logGuess(std::string(1, guessedLetter), response); // Log the guess and response
-
-        // Handle invalid responses
-        if (response != "yes" && response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue; // Skip to the next iteration
-        }
-
-        if (response == "yes") {
-            for (size_t i = 0; i < secretWord.length(); ++i) {
-                if (secretWord[i] == guessedLetter) {
-                    guessedWord[i] = guessedLetter;
-                }
-            }
-            displayGuessedWord(guessedWord); // Display the updated guessed word
-        } else if (response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue;
-        }
-
-        ++questionsAsked;
-        std::cout << "Questions remaining: " << (maxQuestions - questionsAsked) << "\n";
-    }
-
-    if (guessedWord == secretWord) {
-        std::cout << "Knowsall guessed your word: " << secretWord << "\n";
-        return; // Fixed: Added return after successful guess
-    } else {
-        std::cout << "Knowsall couldn't guess your word within " << maxQuestions << " questions.\n";
-    }
-}
 
 /**
- * Challenging mode.
- * Knowsall guesses the word with stricter rules and fewer guesses.
+ * Function to suggest dictionary words after a word was rejected.
+ * Lists a few words sharing the longest prefix (of at least two letters) that any word has.
+ * @param index The dictionary's lookup index.
+ * @param dictionary The dictionary.
+ * @param word The rejected word.
  */
-void challengingMode(const std::string& secretWord, const std::vector<std::string>& dictionary) {
-    std::unordered_set<char> guessedLetters;
-    std::string guessedWord(secretWord.length(), '_');
-    int maxQuestions = 10; // Reduced number of guesses
-    int questionsAsked = 0;
-
-    std::cout << "\nKnowsall will guess your word in Challenging Mode!\n";
-    std::cout << "Rules: Knowsall has only " << maxQuestions << " guesses, and incorrect guesses will cost extra.\n";
-
-    std::vector<std::string> possibleWords = dictionary;
-
-    while (questionsAsked < maxQuestions && guessedWord != secretWord) {
-        // Filter the dictionary based on the current guessed word pattern
-        possibleWords = filterWords(possibleWords, guessedWord, guessedLetters);
-
-        if (possibleWords.empty()) {
-            std::cout << "Knowsall has no more possible words to guess.\n";
-            break;
-        }
-
-        // Calculate letter frequencies in the remaining possible words
-        auto letterFrequencies = calculateLetterFrequencies(possibleWords, guessedLetters);
-
-        // Find the most frequent letter
-        char guessedLetter = '\0';
-        int maxFrequency = 0;
-        for (const auto& pair : letterFrequencies) {
-            char letter = pair.first;
-            int frequency = pair.second;
-            if (frequency > maxFrequency) {
-                guessedLetter = letter;
-                maxFrequency = frequency;
-            }
-        }
-
-        if (guessedLetter == '\0') {
-            std::cout << "Knowsall has run out of letters to guess.\n";
-            break;
-        }
-
-        guessedLetters.insert(guessedLetter);
-
-        std::cout << "Is the letter '" << guessedLetter << "' in your word? (yes/no): ";
-        std::string response;
-        getUserResponseWithTimer(response, 5); // 5-second timer for user response
-
-        // Handle invalid responses
-        if (response != "yes" && response != "no") {
-            std::cout << "Invalid response. Please answer 'yes' or 'no'.\n";
-            continue; // Skip to the next iteration
-        }
-
-        if (response == "yes") {
-            for (size_t i = 0; i < secretWord.length(); ++i) {
-                if (secretWord[i] == guessedLetter) {
-                    guessedWord[i] = guessedLetter;
-                }
-            }
-            displayGuessedWord(guessedWord); // Display the updated guessed word
-        } else if (response == "no") {
-            std::cout << "Incorrect guess! Knowsall loses an extra chance.\n";
-            questionsAsked += 2; // Penalty for incorrect guesses
-        }
-
-        ++questionsAsked;
-        std::cout << "Questions remaining: " << (maxQuestions - questionsAsked) << "\n";
-    }
-
-    if (guessedWord == secretWord) {
-        std::cout << "Knowsall guessed your word: " << secretWord << "\n";
-    } else {
-        std::cout << "Knowsall couldn't guess your word within " << maxQuestions << " questions.\n";
+void printSuggestions(const WordIndex& index, const Dictionary& dictionary, const std::string& word) {
+    const size_t kSuggestions = 5;
+    for (size_t length = word.length(); length >= 2; --length) {
+        std::vector<size_t> ids = index.withPrefix(std::string_view(word).substr(0, length), kSuggestions);
+        if (ids.empty()) continue;
+        std::cout << "Did you mean:";
+        for (size_t id : ids) std::cout << " " << dictionary.word(id);
+        std::cout << "\n";
+        return;
     }
 }
 
@@ -660,22 +37,34 @@ void challengingMode(const std::string& secretWord, const std::vector<std::strin
  * Allows the user to play multiple rounds of the game.
  */
 void playGame() {
-    std::vector<std::string> dictionary;
-    if (!loadDictionary("dictionary.txt", dictionary)) {
+    // Edits to the dictionary files are picked up between rounds, without restarting
+    DictionaryWatcher watcher("dictionary.txt");
+    if (!watcher.load()) {
         std::cerr << "Failed to load the dictionary. Exiting...\n";
         return;
     }
+    watcher.watch();
+    ConsoleIO console;
 
-    if (dictionary.empty()) {
-        std::cerr << "The dictionary is empty. Please provide a valid dictionary file.\n";
-        return;
+    // Menu entries come from the strategy registry, in menu order
+    std::vector<const StrategyInfo*> menu;
+    for (const StrategyInfo& info : strategyRegistry()) {
+        if (info.menuChoice > 0) menu.push_back(&info);
     }
+    std::sort(menu.begin(), menu.end(),
+              [](const StrategyInfo* a, const StrategyInfo* b) { return a->menuChoice < b->menuChoice; });
+    int lastChoice = menu.empty() ? 0 : menu.back()->menuChoice;
 
     while (true) {
         std::string secretWord;
         std::cout << "Think of a word from the dictionary and Knowsall will try to guess it.\n";
         std::cout << "Enter your secret word (Knowsall won't peek!): ";
-        std::cin >> secretWord;
+        if (!readConsoleWord(secretWord)) break; // End of input
+
+        // The round keeps this version even if the dictionary is reloaded meanwhile
+        std::shared_ptr<const DictionarySnapshot> snapshot = watcher.current();
+        const Dictionary& dictionary = snapshot->dictionary();
+        const WordIndex& index = snapshot->index();
 
         // Validate the input for secretWord
         if (secretWord.empty()) {
@@ -688,26 +77,37 @@ void playGame() {
             continue;
         }
 
-        if (std::find(dictionary.begin(), dictionary.end(), secretWord) == dictionary.end()) {
+        // Any capitalisation is accepted; the game uses the dictionary's spelling
+        size_t wordId = index.find(secretWord, true);
+        if (wordId == WordIndex::npos) {
             std::cout << "The word is not in the dictionary. Please choose a valid word.\n";
+            printSuggestions(index, dictionary, secretWord);
             continue;
         }
+        secretWord = dictionary.word(wordId);
 
-        int choice;
+        int choice = 0;
+        const StrategyInfo* mode = nullptr;
         while (true) {
             std::cout << "\nChoose a guessing mode:\n";
             std::cout << "0. Exit\n"; // Exit option
-            std::cout << "1. Randomized Letter-by-Letter Guessing\n"; // Replaced Game Mode 1
-            std::cout << "2. Randomized Word-by-Word Guessing\n";     // Replaced Game Mode 2
-            std::cout << "3. Frequency-Based Guessing\n";
-            std::cout << "4. Random Word Guessing\n";
-            std::cout << "5. AI Guessing with Enhancements\n";
-            std::cout << "6. Challenging Mode\n";
-            std::cout << "Enter your choice (0-6): ";
-            std::cin >> choice;
-
-            if (choice >= 0 && choice <= 6) break;
-            std::cout << "Invalid choice. Please enter a number between 0 and 6.\n";
+            for (const StrategyInfo* info : menu) {
+                std::cout << info->menuChoice << ". " << info->title << "\n";
+            }
+            std::cout << "Enter your choice (0-" << lastChoice << "): ";
+            std::string choiceText;
+            if (!readConsoleWord(choiceText)) break; // End of input exits like choice 0
+            char* end;
+            choice = static_cast<int>(std::strtol(choiceText.c_str(), &end, 10));
+            if (*end != '\0') choice = -1; // Not a number
+
+            if (choice == 0) break;
+            auto it = std::find_if(menu.begin(), menu.end(), [&](const StrategyInfo* info) { return info->menuChoice == choice; });
+            if (it != menu.end()) {
+                mode = *it;
+                break;
+            }
+            std::cout << "Invalid choice. Please enter a number between 0 and " << lastChoice << ".\n";
         }
 
         if (choice == 0) {
@@ -715,34 +115,16 @@ void playGame() {
             break; // Exit the game loop
         }
 
-        switch (choice) {
-            case 1:
-                randomizedLetterByLetterGuessing(secretWord, dictionary); // Mode 1 replaced with Mode 7
-                break;
-            case 2:
-                randomizedWordByWordGuessing(secretWord, dictionary);     // Mode 2 replaced with Mode 8
-                break;
-            case 3:
-                frequencyBasedGuessing(secretWord, dictionary);
-                break;
-            case 4:
-                randomWordGuessing(secretWord, dictionary);
-                break;
-            case 5:
-                aiGuessingWithEnhancements(secretWord, dictionary);
-                break;
-            case 6:
-                challengingMode(secretWord, dictionary);
-                break;
-            default:
-                std::cout << "Invalid choice. Exiting...\n";
-                break;
-        }
+        console.startGame(mode->name);
+        reseedGameRng(); // a fresh seed for the log, so the game can be replayed
+        ProfileStats before = profileSnapshot();
+        mode->play(*mode, secretWord, snapshot->store(), console);
+        printProfile(profileSnapshot() - before, std::cout); // Only in profile builds
 
         std::string playAgain;
         while (true) {
             std::cout << "\nDo you want to play again? (yes/no): ";
-            std::cin >> playAgain;
+            if (!readConsoleWord(playAgain)) playAgain = "no";
 
             if (playAgain == "yes" || playAgain == "no") break;
             std::cout << "Invalid response. Please enter 'yes' or 'no'.\n";
@@ -756,6 +138,136 @@ void playGame() {
 }
 
 // Main function to start the game
-int main() {
+// Usage: knowsall [--batch [--strategy NAME] [--limit N] [--threads N] [--seed N] [--lockstep 0|1] [--cache ENTRIES]
+//                          [--log FILE [--log-format jsonl|binary]]]
+//        knowsall --serve SOCKET_PATH|tcp:PORT [--log FILE [--log-format jsonl|binary]]
+//        knowsall --replay LOG [--strategy NAME] [--dictionary FILE] [--threads N] [--show N]
+int main(int argc, char* argv[]) {
+    if (argc > 2 && std::string(argv[1]) == "--serve") {
+        std::string logFile;
+        LogFormat logFormat = LogFormat::Jsonl;
+        for (int i = 3; i < argc; i += 2) {
+            std::string flag = argv[i];
+            if (i + 1 == argc) {
+                std::cerr << "Missing value for " << flag << "\n";
+                return 1;
+            }
+            if (flag == "--log") {
+                logFile = argv[i + 1];
+            } else if (flag == "--log-format") {
+                std::string format = argv[i + 1];
+                if (format != "jsonl" && format != "binary") {
+                    std::cerr << "Unknown log format: " << format << " (use jsonl or binary)\n";
+                    return 1;
+                }
+                logFormat = format == "binary" ? LogFormat::Binary : LogFormat::Jsonl;
+            } else {
+                std::cerr << "Unknown option: " << flag << "\n";
+                return 1;
+            }
+        }
+
+        // Sessions share the current snapshot; edits to the dictionary files reach new games live
+        DictionaryWatcher watcher("dictionary.txt");
+        if (!watcher.load()) {
+            std::cerr << "Failed to load the dictionary. Exiting...\n";
+            return 1;
+        }
+        GameLog gameLog; // declared before the server, so it is flushed after the last game
+        GameServer server(watcher, logFile.empty() ? nullptr : &gameLog);
+        // Before the watcher and log threads start, so they inherit the blocked signals
+        if (!server.stopOnSignals()) {
+            std::cerr << "Warning: Ctrl-C will end the server without flushing the game log.\n";
+        }
+        if (!watcher.watch()) {
+            std::cerr << "Warning: Dictionary changes will need a restart.\n";
+        }
+        if (!logFile.empty() && !gameLog.open(logFile, logFormat)) {
+            return 1;
+        }
+
+        if (!server.listen(argv[2])) {
+            return 1;
+        }
+        std::cout << "Knowsall is serving games on " << argv[2] << "\n";
+        server.run();
+        return 0;
+    }
+
+    if (argc > 2 && std::string(argv[1]) == "--replay") {
+        ReplayOptions options;
+        options.logFile = argv[2];
+        for (int i = 3; i < argc; i += 2) {
+            std::string flag = argv[i];
+            if (i + 1 == argc) {
+                std::cerr << "Missing value for " << flag << "\n";
+                return 1;
+            }
+            if (flag == "--strategy") {
+                options.strategy = argv[i + 1];
+            } else if (flag == "--dictionary") {
+                options.dictionaryFile = argv[i + 1];
+            } else if (flag == "--threads") {
+                if (!parseNumber(flag, argv[i + 1], options.threads)) return 1;
+            } else if (flag == "--show") {
+                if (!parseNumber(flag, argv[i + 1], options.show)) return 1;
+            } else {
+                std::cerr << "Unknown option: " << flag << "\n";
+                return 1;
+            }
+        }
+        return runReplay(options, std::cout);
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        BatchOptions options;
+        options.openingBook = "dictionary.book";
+        options.decisionTree = "dictionary.tree";
+        for (int i = 2; i < argc; i += 2) {
+            std::string flag = argv[i];
+            if (i + 1 == argc) {
+                std::cerr << "Missing value for " << flag << "\n";
+                return 1;
+            }
+            if (flag == "--strategy") {
+                options.strategy = argv[i + 1];
+            } else if (flag == "--limit") {
+                if (!parseNumber(flag, argv[i + 1], options.limit)) return 1;
+            } else if (flag == "--threads") {
+                if (!parseNumber(flag, argv[i + 1], options.threads)) return 1;
+            } else if (flag == "--seed") {
+                if (!parseNumber(flag, argv[i + 1], options.seed)) return 1;
+            } else if (flag == "--lockstep") {
+                std::string lockstep = argv[i + 1];
+                if (lockstep != "0" && lockstep != "1") {
+                    std::cerr << "Invalid value for " << flag << ": " << lockstep << " (use 0 or 1)\n";
+                    return 1;
+                }
+                options.lockstep = lockstep == "1";
+            } else if (flag == "--cache") {
+                if (!parseNumber(flag, argv[i + 1], options.cacheEntries)) return 1;
+            } else if (flag == "--log") {
+                options.logFile = argv[i + 1];
+            } else if (flag == "--log-format") {
+                std::string format = argv[i + 1];
+                if (format != "jsonl" && format != "binary") {
+                    std::cerr << "Unknown log format: " << format << " (use jsonl or binary)\n";
+                    return 1;
+                }
+                options.logFormat = format == "binary" ? LogFormat::Binary : LogFormat::Jsonl;
+            } else {
+                std::cerr << "Unknown option: " << flag << "\n";
+                return 1;
+            }
+        }
+
+        Dictionary dictionary;
+        if (!loadDictionary("dictionary.txt", dictionary) || dictionary.empty()) {
+            std::cerr << "Failed to load the dictionary. Exiting...\n";
+            return 1;
+        }
+        return runBatch(dictionary, options, std::cout);
+    }
+
     playGame();
 }
\ No newline at end of file
@@ -0,0 +1,434 @@
+#include "Dictionary.hpp"
+#include "CandidateStore.hpp"
+#include "CommandLine.hpp"
+#include "GameEngine.hpp"
+#include "GameIO.hpp"
+#include "GameState.hpp"
+#include "LetterHistogram.hpp"
+#include "QuestionCache.hpp"
+#include "Random.hpp"
+#include "Strategy.hpp"
+#include "WordIndex.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps the compiler from dropping a computation whose result is unused.
+template <typename T>
+void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// One measured fixture at one dictionary size.
+struct BenchResult {
+    std::string name;
+    size_t words = 0;
+    size_t iterations = 0;
+    double nanosPerIteration = 0;    // wall time
+    double cpuNanosPerIteration = 0; // process CPU time
+    double itemsPerSecond = 0; // items processed per second (words, games, lookups); 0 if not meaningful
+    double bytesPerWord = 0;   // dictionary image size, for the load fixtures; 0 for the others
+};
+
+// A fixture runs its body `iterations` times and returns the number of items it processed.
+using BenchBody = std::function<size_t(size_t iterations)>;
+
+/**
+ * Function to time a fixture.
+ * Like Google Benchmark, the iteration count grows until one run lasts at least
+ * minSeconds, and the last run is reported, so fast and slow fixtures get
+ * comparable precision.
+ * @param minSeconds Shortest run that counts as a measurement.
+ * @param body The fixture.
+ * @return Iterations, time per iteration and throughput of the final run.
+ */
+BenchResult measure(double minSeconds, const BenchBody& body) {
+    BenchResult result;
+    size_t iterations = 1;
+    while (true) {
+        auto start = Clock::now();
+        std::clock_t cpuStart = std::clock();
+        size_t items = body(iterations);
+        double cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds >= minSeconds || iterations >= (size_t(1) << 30)) {
+            result.iterations = iterations;
+            result.nanosPerIteration = seconds * 1e9 / iterations;
+            result.cpuNanosPerIteration = cpuSeconds * 1e9 / iterations;
+            result.itemsPerSecond = seconds > 0 ? items / seconds : 0;
+            return result;
+        }
+        // Aim a little past the target so the next run is usually the last
+        double scale = seconds > 0 ? 1.4 * minSeconds / seconds : 10;
+        iterations = static_cast<size_t>(iterations * std::clamp(scale, 2.0, 10.0));
+    }
+}
+
+/**
+ * Function to write a synthetic dictionary.
+ * Words are distinct, 3 to 14 letters long with most around 8, and drawn
+ * from English letter frequencies, so bucket sizes and letter counts look
+ * like a real word list of the same size.
+ * @param filename The text file to write.
+ * @param count Number of words.
+ * @param seed Seeds the generator; the same seed writes the same file.
+ * @return True if the file was written.
+ */
+bool writeSyntheticDictionary(const std::string& filename, size_t count, uint64_t seed) {
+    static const double kLetterWeights[kAlphabetSize] = {
+        8.2, 1.5, 2.8, 4.3, 12.7, 2.2, 2.0, 6.1, 7.0, 0.2, 0.8, 4.0, 2.4,
+        6.7, 7.5, 1.9, 0.1, 6.0, 6.3, 9.1, 2.8, 1.0, 2.4, 0.2, 2.0, 0.1};
+    static const double kLengthWeights[] = {2, 5, 9, 12, 14, 14, 12, 10, 8, 6, 4, 3}; // lengths 3-14
+
+    std::mt19937_64 engine(seed);
+    std::discrete_distribution<int> letters(std::begin(kLetterWeights), std::end(kLetterWeights));
+    std::discrete_distribution<int> lengths(std::begin(kLengthWeights), std::end(kLengthWeights));
+
+    std::ofstream file(filename);
+    if (!file) {
+        std::cerr << "Error: Could not write " << filename << "\n";
+        return false;
+    }
+    std::unordered_set<std::string> seen;
+    seen.reserve(count);
+    std::string word;
+    while (seen.size() < count) {
+        word.resize(3 + lengths(engine));
+        for (char& c : word) c = static_cast<char>('a' + letters(engine));
+        if (seen.insert(word).second) file << word << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+// Evenly spaced word ids, the same sampling --batch --limit uses.
+std::vector<size_t> sampleWords(const Dictionary& dictionary, size_t count) {
+    std::vector<size_t> ids;
+    count = std::min(count, dictionary.size());
+    for (size_t i = 0; i < count; ++i) ids.push_back(i * dictionary.size() / count);
+    return ids;
+}
+
+/**
+ * Function to run every fixture selected by the filter on one dictionary.
+ * @param textFile The synthetic dictionary's text file.
+ * @param indexFile Where to write its compiled index; the compact index goes next to it.
+ * @param filter Only fixtures whose name contains this run; empty runs all.
+ * @param minSeconds Shortest measured run per fixture.
+ * @param results Receives one result per fixture.
+ * @return False if the dictionary could not be loaded or compiled.
+ */
+bool runFixtures(const std::string& textFile, const std::string& indexFile, const std::string& filter, double minSeconds,
+                 std::vector<BenchResult>& results) {
+    std::string compactFile = indexFile + ".compact";
+    Dictionary dictionary, compact;
+    if (!dictionary.loadText(textFile) || !dictionary.writeIndex(indexFile) ||
+        !compact.loadText(textFile, ImageLayout::Compact) || !compact.writeIndex(compactFile)) {
+        std::cerr << "Error: Could not prepare the synthetic dictionary " << textFile << "\n";
+        std::remove(compactFile.c_str());
+        return false;
+    }
+    CandidateStore store(dictionary);
+    CandidateStore compactStore(compact);
+    QuestionCache cache;
+    CandidateStore cachedStore(dictionary);
+    cachedStore.setQuestionCache(&cache);
+    std::vector<size_t> sample = sampleWords(dictionary, 1024);
+
+    // The most common length, where filtering and counting cost the most
+    size_t length = 0;
+    for (size_t l = 1; l < dictionary.bucketCount(); ++l) {
+        const LengthBucket* bucket = dictionary.bucket(l);
+        if (bucket && (length == 0 || bucket->count > dictionary.bucket(length)->count)) length = l;
+    }
+
+    auto run = [&](const std::string& name, const BenchBody& body, double bytesPerWord = 0) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) return;
+        BenchResult result = measure(minSeconds, body);
+        result.name = name;
+        result.words = dictionary.size();
+        result.bytesPerWord = bytesPerWord;
+        results.push_back(result);
+    };
+
+    // loadDictionary: parsing the text file, and mapping the compiled index instead
+    run("load_text", [&](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            Dictionary loaded;
+            loaded.loadText(textFile);
+            keep(loaded.size());
+        }
+        return iterations * dictionary.size();
+    });
+    for (const Dictionary* image : {&dictionary, &compact}) {
+        bool isCompact = image == &compact;
+        run(isCompact ? "load_index_compact" : "load_index", [&](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                Dictionary loaded;
+                loaded.openIndex(isCompact ? compactFile : indexFile);
+                keep(loaded.size());
+            }
+            return iterations * dictionary.size();
+        }, static_cast<double>(image->imageBytes()) / image->size());
+    }
+    std::remove(compactFile.c_str());
+
+    // filterWords: narrowing the largest bucket by a miss, a hit and another miss
+    auto filterWords = [&](const CandidateStore& store, size_t iterations) {
+        GameState state(store, length);
+        const std::string probe(dictionary.bucket(length)->word(0));
+        char hit = probe[probe.length() / 2];
+        std::string misses;
+        for (char c = 'z'; c >= 'a' && misses.length() < 2; --c) {
+            if (probe.find(c) == std::string::npos) misses += c;
+        }
+        for (size_t i = 0; i < iterations; ++i) {
+            state.reset(store, length);
+            state.apply(LetterAnswer{misses[0], 0});
+            state.apply(GameState::answerFor(probe, hit));
+            state.apply(LetterAnswer{misses[1], 0});
+            keep(state.candidates().narrowed());
+        }
+        return iterations * dictionary.bucket(length)->count;
+    };
+    run("filter_words", [&](size_t iterations) { return filterWords(store, iterations); });
+    run("filter_words_compact", [&](size_t iterations) { return filterWords(compactStore, iterations); });
+
+    // calculateLetterFrequencies: letter counts over the largest bucket, narrowed so the
+    // precomputed whole-bucket counts do not apply
+    run("letter_frequencies", [&](size_t iterations) {
+        CandidateSet candidates(store, length);
+        candidates.applyAnswer('q', std::string(length, '_'));
+        for (size_t i = 0; i < iterations; ++i) {
+            LetterHistogram counts = candidates.letterCounts();
+            keep(counts);
+        }
+        return iterations * dictionary.bucket(length)->count;
+    });
+
+    // Dictionary membership: hits, misses and case-insensitive hits
+    WordIndex index(dictionary);
+    run("membership_build", [&](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            WordIndex built(dictionary);
+            keep(built.contains(""));
+        }
+        return iterations * dictionary.size();
+    });
+    run("membership_hit", [&](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) keep(index.find(dictionary.word(sample[i % sample.size()])));
+        return iterations;
+    });
+    run("membership_miss", [&](size_t iterations) {
+        std::string missing = "zzzzqqqqx";
+        for (size_t i = 0; i < iterations; ++i) {
+            missing[i % missing.length()] ^= 1;
+            keep(index.find(missing));
+        }
+        return iterations;
+    });
+    run("membership_ignore_case", [&](size_t iterations) {
+        std::vector<std::string> upper;
+        for (size_t id : sample) {
+            std::string word(dictionary.word(id));
+            for (char& c : word) c = static_cast<char>(c - 'a' + 'A');
+            upper.push_back(word);
+        }
+        for (size_t i = 0; i < iterations; ++i) keep(index.find(upper[i % upper.size()], true));
+        return iterations;
+    });
+
+    // Full games: one iteration is one headless game against the oracle; the compact image
+    // is timed with the mode that filters the most, the question cache (warm after the first
+    // pass over the sample) with the two modes that count letters
+    auto solve = [&](const StrategyInfo& mode, const CandidateStore& store, size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            size_t id = sample[i % sample.size()];
+            std::string secretWord(dictionary.word(id));
+            OracleIO oracle(secretWord);
+            seedGameRng(mixSeed(id));
+            keep(mode.playHeadless(mode, secretWord, store, oracle));
+        }
+        return iterations;
+    };
+    for (const StrategyInfo& mode : strategyRegistry()) {
+        run(std::string("solve/") + mode.name, [&](size_t iterations) { return solve(mode, store, iterations); });
+    }
+    if (const StrategyInfo* mode = findStrategy("ai")) {
+        run("solve_compact/ai", [&](size_t iterations) { return solve(*mode, compactStore, iterations); });
+    }
+    for (const char* name : {"ai", "entropy"}) {
+        if (const StrategyInfo* mode = findStrategy(name)) {
+            run(std::string("solve_cached/") + name, [&](size_t iterations) { return solve(*mode, cachedStore, iterations); });
+        }
+    }
+    return true;
+}
+
+// Parses "10000,100000,1000000" (k and m suffixes allowed) into sizes.
+bool parseSizes(const std::string& list, std::vector<size_t>& sizes) {
+    sizes.clear();
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) end = list.size();
+        std::string item = list.substr(start, end - start);
+        char* rest = nullptr;
+        unsigned long long value = std::strtoull(item.c_str(), &rest, 10);
+        if (*rest == 'k' || *rest == 'K') {
+            value *= 1000;
+            ++rest;
+        } else if (*rest == 'm' || *rest == 'M') {
+            value *= 1000000;
+            ++rest;
+        }
+        if (item.empty() || value == 0 || *rest != '\0') return false;
+        sizes.push_back(value);
+        start = end + 1;
+    }
+    return !sizes.empty();
+}
+
+void printConsole(const std::vector<BenchResult>& results, std::ostream& out) {
+    out << std::left << std::setw(36) << "benchmark" << std::right << std::setw(10) << "words"
+        << std::setw(16) << "ns/iter" << std::setw(14) << "iterations" << std::setw(16) << "items/s"
+        << std::setw(12) << "bytes/word" << "\n";
+    for (const BenchResult& result : results) {
+        out << std::left << std::setw(36) << result.name << std::right << std::setw(10) << result.words
+            << std::fixed << std::setprecision(1) << std::setw(16) << result.nanosPerIteration
+            << std::setw(14) << result.iterations << std::setprecision(0) << std::setw(16) << result.itemsPerSecond;
+        if (result.bytesPerWord > 0) out << std::setprecision(1) << std::setw(12) << result.bytesPerWord;
+        out << "\n";
+    }
+}
+
+void printCsv(const std::vector<BenchResult>& results, std::ostream& out) {
+    out << "name,words,iterations,ns_per_iteration,items_per_second,bytes_per_word\n";
+    for (const BenchResult& result : results) {
+        out << result.name << "," << result.words << "," << result.iterations << ","
+            << std::fixed << std::setprecision(1) << result.nanosPerIteration << ","
+            << std::setprecision(0) << result.itemsPerSecond << ",";
+        if (result.bytesPerWord > 0) out << std::setprecision(1) << result.bytesPerWord;
+        out << "\n";
+    }
+}
+
+// Same shape as Google Benchmark's --benchmark_format=json, so its compare tools can diff two runs.
+void printJson(const std::vector<BenchResult>& results, std::ostream& out) {
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    out << "{\n  \"context\": {\n"
+        << "    \"date\": \"" << date << "\",\n"
+        << "    \"num_cpus\": " << sysconf(_SC_NPROCESSORS_ONLN) << ",\n"
+        << "    \"letter_kernel\": \"" << letterKernelName() << "\"\n"
+        << "  },\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+        out << (i ? "," : "") << "\n    {\"name\": \"" << result.name << "/" << result.words << "\", "
+            << "\"run_type\": \"iteration\", \"iterations\": " << result.iterations << ", "
+            << std::fixed << std::setprecision(1)
+            << "\"real_time\": " << result.nanosPerIteration << ", \"cpu_time\": " << result.cpuNanosPerIteration << ", "
+            << "\"time_unit\": \"ns\", " << std::setprecision(0) << "\"items_per_second\": " << result.itemsPerSecond;
+        if (result.bytesPerWord > 0) out << std::setprecision(1) << ", \"bytes_per_word\": " << result.bytesPerWord;
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+} // namespace
+
+/**
+ * Microbenchmarks for the solver's hot paths.
+ * Generates synthetic dictionaries of each size, then times loading (text
+ * and compiled index, full and compact, with the image size per word),
+ * candidate filtering on both layouts, letter counting, dictionary
+ * membership and a full headless game of every strategy (and of the
+ * letter-counting ones with the question cache). Output is a table,
+ * CSV, or JSON in Google Benchmark's format, for comparing two builds.
+ *
+ * Usage: knowsall-bench [--sizes 10k,100k,1m] [--filter TEXT] [--min-time SECONDS]
+ *                       [--format console|csv|json] [--seed N]
+ *        (--filter runs only fixtures whose name contains TEXT, e.g. solve/ or membership)
+ */
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = {10000, 100000, 1000000};
+    std::string filter, format = "console";
+    double minSeconds = 0.5;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; i += 2) {
+        std::string flag = argv[i];
+        if (i + 1 == argc) {
+            std::cerr << "Missing value for " << flag << "\n";
+            return 1;
+        }
+        if (flag == "--sizes") {
+            if (!parseSizes(argv[i + 1], sizes)) {
+                std::cerr << "Invalid sizes: " << argv[i + 1] << "\n";
+                return 1;
+            }
+        } else if (flag == "--filter") {
+            filter = argv[i + 1];
+        } else if (flag == "--min-time") {
+            if (!parseNumber(flag, argv[i + 1], minSeconds)) return 1;
+            if (minSeconds <= 0) {
+                std::cerr << "Invalid value for " << flag << ": " << argv[i + 1] << " (must be more than 0)\n";
+                return 1;
+            }
+        } else if (flag == "--format") {
+            format = argv[i + 1];
+            if (format != "console" && format != "csv" && format != "json") {
+                std::cerr << "Unknown format: " << format << " (use console, csv or json)\n";
+                return 1;
+            }
+        } else if (flag == "--seed") {
+            if (!parseNumber(flag, argv[i + 1], seed)) return 1;
+        } else {
+            std::cerr << "Unknown option: " << flag << "\n";
+            return 1;
+        }
+    }
+
+    char directory[] = "/tmp/knowsall-bench-XXXXXX";
+    if (!mkdtemp(directory)) {
+        std::cerr << "Error: Could not create a temporary directory.\n";
+        return 1;
+    }
+
+    std::vector<BenchResult> results;
+    bool ok = true;
+    for (size_t size : sizes) {
+        std::string stem = std::string(directory) + "/words" + std::to_string(size);
+        if (format == "console") std::cerr << "Running " << size << " words...\n";
+        ok = writeSyntheticDictionary(stem + ".txt", size, mixSeed(seed ^ size)) &&
+             runFixtures(stem + ".txt", stem + ".kdx", filter, minSeconds, results);
+        std::remove((stem + ".txt").c_str());
+        std::remove((stem + ".kdx").c_str());
+        if (!ok) break;
+    }
+    rmdir(directory);
+
+    if (format == "json") {
+        printJson(results, std::cout);
+    } else if (format == "csv") {
+        printCsv(results, std::cout);
+    } else {
+        printConsole(results, std::cout);
+    }
+    return ok ? 0 : 1;
+}
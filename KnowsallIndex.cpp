@@ -0,0 +1,101 @@
+#include "Dictionary.hpp"
+#include "CandidateStore.hpp"
+#include "CommandLine.hpp"
+#include "OpeningBook.hpp"
+#include "DecisionTree.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Dictionary compiler.
+ * Builds the binary index (packed words, length buckets, letter bitsets and
+ * counts) that Knowsall maps at startup, and the opening book of precomputed
+ * first questions that sits next to it. With --tree it also compiles the
+ * full decision tree of that policy, on every core. With --compact the index
+ * leaves out the per-position bitsets, for lexicons too large to hold them
+ * (see ImageLayout).
+ *
+ * Usage: knowsall-index [--book-depth N] [--tree] [--compact] [dictionary.txt] [dictionary.kdx]
+ *        (--book-depth 0 skips the opening book; the default is 4 turns, the most 26)
+ */
+int main(int argc, char* argv[]) {
+    constexpr int kMaxBookDepth = kAlphabetSize; // a game never asks more letters than that
+    int bookDepth = 4;
+    bool buildTree = false;
+    ImageLayout layout = ImageLayout::Full;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--book-depth") {
+            if (i + 1 == argc) {
+                std::cerr << "Missing value for " << arg << "\n";
+                return 1;
+            }
+            if (!parseNumber(arg, argv[++i], bookDepth)) return 1;
+            if (bookDepth > kMaxBookDepth) {
+                std::cerr << "Invalid value for " << arg << ": " << bookDepth << " (at most " << kMaxBookDepth << " turns)\n";
+                return 1;
+            }
+        } else if (arg == "--tree") {
+            buildTree = true;
+        } else if (arg == "--compact") {
+            layout = ImageLayout::Compact;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    std::string input = files.size() > 0 ? files[0] : "dictionary.txt";
+    std::string stem = input.substr(0, input.rfind('.'));
+    std::string output = files.size() > 1 ? files[1] : stem + ".kdx";
+
+    Dictionary dictionary;
+    if (!dictionary.loadText(input, layout)) {
+        return 1;
+    }
+    if (dictionary.empty()) {
+        std::cerr << "The dictionary is empty. Please provide a valid dictionary file.\n";
+        return 1;
+    }
+    if (!dictionary.writeIndex(output)) {
+        std::cerr << "Failed to write the dictionary index.\n";
+        return 1;
+    }
+
+    // Read the file back so a bad index is caught here rather than at game time
+    Dictionary check;
+    if (!check.openIndex(output) || check.size() != dictionary.size()) {
+        std::cerr << "The written index could not be read back: " << output << "\n";
+        return 1;
+    }
+
+    std::cout << "Wrote " << dictionary.size() << " words (" << dictionary.bucketCount() - 1 << " max length, "
+              << (dictionary.imageBytes() + 1023) / 1024 << " KiB" << (layout == ImageLayout::Compact ? ", compact" : "")
+              << ") to " << output << "\n";
+
+    if (bookDepth > 0) {
+        // States with fewer candidates than this are cheap enough to compute live
+        const size_t minCandidates = 64;
+        std::string bookFile = stem + ".book";
+        CandidateStore store(dictionary);
+        OpeningBook book = OpeningBook::build(store, bookDepth, minCandidates);
+        if (!book.save(bookFile, dictionary)) {
+            std::cerr << "Failed to write the opening book.\n";
+            return 1;
+        }
+        std::cout << "Wrote " << book.size() << " opening positions (" << bookDepth << " turns) to " << bookFile << "\n";
+    }
+
+    if (buildTree) {
+        std::string treeFile = stem + ".tree";
+        CandidateStore store(dictionary);
+        DecisionTree tree = DecisionTree::build(store);
+        if (tree.empty() || !tree.save(treeFile, dictionary)) {
+            std::cerr << "Failed to write the decision tree.\n";
+            return 1;
+        }
+        std::cout << "Wrote " << tree.nodes() << " decision tree nodes (" << tree.edges() << " answers) to " << treeFile << "\n";
+    }
+    return 0;
+}
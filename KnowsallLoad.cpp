@@ -0,0 +1,219 @@
+#include "CommandLine.hpp"
+#include "Dictionary.hpp"
+#include "EventLoop.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// One simulated player: plays its share of the games on one connection, answering as an oracle.
+struct Client {
+    explicit Client(int fd) : reader(fd) {}
+
+    InputReader reader;
+    std::string secretWord;
+    size_t nextGame = 0;  // index into this client's games
+    size_t gamesLeft = 0;
+    Clock::time_point sentAt;
+};
+
+// Connects to TCP port on 127.0.0.1, or to the Unix-domain socket path address if port is 0; -1 on failure.
+int connectTo(const std::string& address, uint16_t port) {
+    bool tcp = port != 0;
+    int fd = socket(tcp ? AF_INET : AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    int connected;
+    if (tcp) {
+        sockaddr_in in{};
+        in.sin_family = AF_INET;
+        in.sin_port = htons(port);
+        in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        connected = connect(fd, reinterpret_cast<sockaddr*>(&in), sizeof(in));
+    } else {
+        sockaddr_un un{};
+        un.sun_family = AF_UNIX;
+        std::strncpy(un.sun_path, address.c_str(), sizeof(un.sun_path) - 1);
+        connected = connect(fd, reinterpret_cast<sockaddr*>(&un), sizeof(un));
+    }
+    if (connected != 0) {
+        ::close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+bool sendLine(Client& client, const std::string& line) {
+    std::string message = line + "\n";
+    client.sentAt = Clock::now();
+    return ::send(client.reader.fd(), message.data(), message.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(message.size());
+}
+
+// Value at the given percentile of an unsorted sample (the sample is reordered).
+double percentile(std::vector<double>& sample, double fraction) {
+    if (sample.empty()) return 0;
+    size_t rank = std::min(sample.size() - 1, static_cast<size_t>(fraction * sample.size()));
+    std::nth_element(sample.begin(), sample.begin() + rank, sample.end());
+    return sample[rank];
+}
+
+} // namespace
+
+/**
+ * Load generator for the Knowsall game server.
+ * Opens many connections at once and plays dictionary words on all of them
+ * from one event loop, answering every question from the known word. Reports
+ * the server's throughput in questions per second and its response latency
+ * (time from sending a line to receiving the reply).
+ *
+ * Usage: knowsall-load ADDRESS [--connections N] [--games N] [--strategy NAME] [--dictionary FILE]
+ *        (ADDRESS is the socket path or tcp:PORT given to knowsall --serve;
+ *         --games is per connection, default 100 games on 100 connections)
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: knowsall-load ADDRESS [--connections N] [--games N] [--strategy NAME] [--dictionary FILE]\n";
+        return 1;
+    }
+    std::string address = argv[1];
+    size_t connections = 100, gamesPerConnection = 100;
+    std::string strategy = "ai-enhanced", dictionaryFile = "dictionary.txt";
+    uint16_t port = 0;
+    if (!parseAddress(address, port)) return 1;
+    for (int i = 2; i < argc; i += 2) {
+        std::string flag = argv[i];
+        if (i + 1 == argc) {
+            std::cerr << "Missing value for " << flag << "\n";
+            return 1;
+        }
+        if (flag == "--connections" || flag == "--games") {
+            size_t& count = flag == "--connections" ? connections : gamesPerConnection;
+            if (!parseNumber(flag, argv[i + 1], count)) return 1;
+            if (count == 0) {
+                std::cerr << "Invalid value for " << flag << ": 0 (must be at least 1)\n";
+                return 1;
+            }
+        } else if (flag == "--strategy") {
+            strategy = argv[i + 1];
+        } else if (flag == "--dictionary") {
+            dictionaryFile = argv[i + 1];
+        } else {
+            std::cerr << "Unknown option: " << flag << "\n";
+            return 1;
+        }
+    }
+
+    Dictionary dictionary;
+    if (!dictionary.loadText(dictionaryFile) || dictionary.empty()) {
+        std::cerr << "Failed to load the dictionary. Exiting...\n";
+        return 1;
+    }
+
+    EventLoop loop;
+    std::vector<std::unique_ptr<Client>> clients;
+    std::vector<double> latencies;
+    size_t totalGames = connections * gamesPerConnection, games = 0, wins = 0, questions = 0, open = 0;
+    latencies.reserve(totalGames * 8);
+    bool failed = false;
+
+    // Words are spread evenly over the dictionary, the same way --batch --limit samples them
+    auto startNext = [&](Client& client, size_t index) {
+        size_t game = index * gamesPerConnection + client.nextGame++;
+        client.secretWord = std::string(dictionary.word(game * dictionary.size() / totalGames));
+        return sendLine(client, "new " + strategy + " " + client.secretWord);
+    };
+    auto finish = [&](Client& client) {
+        loop.unwatch(client.reader.fd());
+        ::close(client.reader.fd());
+        if (--open == 0) loop.stop();
+    };
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < connections; ++i) {
+        int fd = connectTo(address, port);
+        if (fd < 0) {
+            std::cerr << "Error: Could not connect to " << address << ": " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        clients.push_back(std::make_unique<Client>(fd));
+        Client& client = *clients.back();
+        client.gamesLeft = gamesPerConnection;
+        ++open;
+
+        loop.watch(fd, [&, i]() {
+            bool connected = client.reader.fill();
+            std::string line;
+            while (client.reader.nextLine(line)) {
+                latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - client.sentAt).count());
+
+                std::string answer;
+                if (line.compare(0, 11, "ask letter ") == 0 && line.size() > 11) {
+                    answer = client.secretWord.find(line[11]) != std::string::npos ? "yes" : "no";
+                } else if (line.compare(0, 9, "ask word ") == 0) {
+                    answer = line.compare(9, std::string::npos, client.secretWord) == 0 ? "yes" : "no";
+                } else if (line.compare(0, 5, "done ") == 0) {
+                    ++games;
+                    wins += line.compare(5, 3, "win") == 0;
+                    if (--client.gamesLeft == 0) {
+                        sendLine(client, "quit");
+                        finish(client);
+                        return;
+                    }
+                    if (!startNext(client, i)) connected = false;
+                    continue;
+                } else {
+                    std::cerr << "Error: Unexpected reply from the server: " << line << "\n";
+                    failed = true;
+                    connected = false;
+                    break;
+                }
+                ++questions;
+                if (!sendLine(client, answer)) connected = false;
+            }
+            if (!connected) {
+                failed = true;
+                finish(client);
+            }
+        });
+    }
+
+    if (gamesPerConnection == 0) return 0;
+    for (size_t i = 0; i < clients.size(); ++i) {
+        if (!startNext(*clients[i], i)) {
+            std::cerr << "Error: Could not send to the server.\n";
+            return 1;
+        }
+    }
+    loop.run();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    double meanLatency = 0;
+    for (double latency : latencies) meanLatency += latency;
+    meanLatency /= latencies.empty() ? 1 : latencies.size();
+
+    std::cout << std::fixed << std::setprecision(1)
+              << connections << " connections, " << games << " games (" << (games ? 100.0 * wins / games : 0.0) << "% won), "
+              << questions << " questions in " << std::setprecision(2) << seconds << " s\n"
+              << std::setprecision(0) << "throughput: " << (seconds > 0 ? questions / seconds : 0.0) << " questions/s, "
+              << (seconds > 0 ? games / seconds : 0.0) << " games/s\n"
+              << std::setprecision(1) << "latency: mean " << meanLatency << " us, p50 " << percentile(latencies, 0.50)
+              << " us, p99 " << percentile(latencies, 0.99) << " us\n";
+    return failed ? 1 : 0;
+}
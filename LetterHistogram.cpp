@@ -0,0 +1,90 @@
+#include "LetterHistogram.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KNOWSALL_HAVE_AVX2_KERNEL 1
+#endif
+
+namespace {
+
+uint64_t andPopcountScalar(const uint64_t* a, const uint64_t* b, size_t blocks) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < blocks; ++i) {
+        total += __builtin_popcountll(a[i] & b[i]);
+    }
+    return total;
+}
+
+#ifdef KNOWSALL_HAVE_AVX2_KERNEL
+// Nibble lookup popcount: each byte's count comes from two table shuffles,
+// and _mm256_sad_epu8 folds the byte counts into four 64-bit lanes.
+__attribute__((target("avx2")))
+uint64_t andPopcountAvx2(const uint64_t* a, const uint64_t* b, size_t blocks) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibble = _mm256_set1_epi8(0x0f);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i total = zero;
+
+    size_t i = 0;
+    for (; i + 4 <= blocks; i += 4) {
+        __m256i v = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        __m256i lo = _mm256_and_si256(v, lowNibble);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibble);
+        __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, zero));
+    }
+
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + andPopcountScalar(a + i, b + i, blocks - i);
+}
+#endif
+
+using AndPopcount = uint64_t (*)(const uint64_t*, const uint64_t*, size_t);
+
+AndPopcount selectKernel() {
+#ifdef KNOWSALL_HAVE_AVX2_KERNEL
+    __builtin_cpu_init(); // Needed because this runs during static initialisation
+    if (__builtin_cpu_supports("avx2")) return andPopcountAvx2;
+#endif
+    return andPopcountScalar;
+}
+
+const AndPopcount kAndPopcount = selectKernel();
+
+// Blocks per tile in countLettersBatch: 26 letter bitsets of 128 blocks are 26 KiB, inside L1
+constexpr size_t kTileBlocks = 128;
+
+} // namespace
+
+void countLetters(const uint64_t* candidates, const LengthBucket& bucket, uint32_t skipLetters, LetterHistogram& counts) {
+    for (int letter = 0; letter < kAlphabetSize; ++letter) {
+        counts[letter] = (skipLetters & (uint32_t{1} << letter))
+            ? 0
+            : static_cast<uint32_t>(kAndPopcount(candidates, bucket.letterMask(letter), bucket.blocks));
+    }
+}
+
+void countLettersBatch(const uint64_t* const* candidates, const uint32_t* skipLetters, size_t sets,
+                       const LengthBucket& bucket, LetterHistogram* counts) {
+    for (size_t set = 0; set < sets; ++set) counts[set].fill(0);
+
+    for (size_t tile = 0; tile < bucket.blocks; tile += kTileBlocks) {
+        size_t blocks = bucket.blocks - tile < kTileBlocks ? bucket.blocks - tile : kTileBlocks;
+        for (size_t set = 0; set < sets; ++set) {
+            for (int letter = 0; letter < kAlphabetSize; ++letter) {
+                if (skipLetters[set] & (uint32_t{1} << letter)) continue;
+                counts[set][letter] += static_cast<uint32_t>(kAndPopcount(candidates[set] + tile, bucket.letterMask(letter) + tile, blocks));
+            }
+        }
+    }
+}
+
+const char* letterKernelName() {
+#ifdef KNOWSALL_HAVE_AVX2_KERNEL
+    if (kAndPopcount == andPopcountAvx2) return "avx2";
+#endif
+    return "scalar";
+}
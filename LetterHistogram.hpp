@@ -0,0 +1,54 @@
+#ifndef LETTER_HISTOGRAM_HPP
+#define LETTER_HISTOGRAM_HPP
+
+#include "Dictionary.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Number of candidate words containing each letter 'a'-'z' (per word, not per occurrence).
+using LetterHistogram = std::array<uint32_t, kAlphabetSize>;
+
+/**
+ * Counts, for every letter, how many candidates contain it.
+ * Each count is popcount(candidates AND letterBits[letter]) over the bucket's
+ * bitsets, done 256 bits at a time with AVX2 when the CPU supports it and
+ * with scalar popcounts otherwise.
+ * @param candidates Candidate bitset over the bucket (bucket.blocks words).
+ * @param bucket The length bucket the bitset belongs to.
+ * @param skipLetters Bit i set means letter 'a' + i is left at zero.
+ * @param counts Receives the histogram.
+ */
+void countLetters(const uint64_t* candidates, const LengthBucket& bucket, uint32_t skipLetters, LetterHistogram& counts);
+
+/**
+ * countLetters for many candidate bitsets over the same bucket in one pass.
+ * The bucket is walked in tiles small enough that its 26 letter bitsets stay
+ * in L1 while every candidate set is counted against them, so the letter
+ * bitsets are read from memory once per call instead of once per set.
+ * @param candidates sets candidate bitsets over the bucket.
+ * @param skipLetters One skip mask per set.
+ * @param sets Number of sets.
+ * @param bucket The length bucket every set belongs to.
+ * @param counts Receives one histogram per set.
+ */
+void countLettersBatch(const uint64_t* const* candidates, const uint32_t* skipLetters, size_t sets,
+                       const LengthBucket& bucket, LetterHistogram* counts);
+
+// Letter with the highest count ('a' wins ties), or '\0' if every count is zero.
+inline char mostFrequentLetter(const LetterHistogram& counts) {
+    char best = '\0';
+    uint32_t bestCount = 0;
+    for (int letter = 0; letter < kAlphabetSize; ++letter) {
+        if (counts[letter] > bestCount) {
+            best = static_cast<char>('a' + letter);
+            bestCount = counts[letter];
+        }
+    }
+    return best;
+}
+
+// Which kernel countLetters dispatches to on this machine ("avx2" or "scalar").
+const char* letterKernelName();
+
+#endif // LETTER_HISTOGRAM_HPP
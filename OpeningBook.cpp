@@ -0,0 +1,204 @@
+#include "OpeningBook.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+constexpr char kBookMagic[8] = {'K', 'N', 'O', 'W', 'B', 'O', 'O', 'K'};
+constexpr uint32_t kBookVersion = 2;
+
+struct BookHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t depth;
+    uint64_t fingerprint; // Dictionary::fingerprint() of the dictionary it was built from
+    uint64_t entryCount;
+    uint64_t patternBytes; // the patterns follow the entries
+};
+
+uint64_t stateKey(std::string_view guessedWord, uint32_t guessedLetters) {
+    uint64_t hash = 0xcbf29ce484222325ULL; // FNV-1a
+    for (char c : guessedWord) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    hash ^= guessedLetters;
+    hash *= 0x100000001b3ULL;
+    return hash;
+}
+
+} // namespace
+
+/**
+ * Function to build the opening book.
+ * Follows the policy down every answer the dictionary can give,
+ * recording the letter it asks in each state.
+ * @param store The dictionary index.
+ * @param depth Number of turns to cover.
+ * @param minCandidates Smallest candidate set worth storing a move for.
+ * @return The book.
+ */
+OpeningBook OpeningBook::build(const CandidateStore& store, int depth, size_t minCandidates) {
+    OpeningBook book;
+    book.depth_ = depth;
+
+    for (size_t length = 1; length < store.dictionary().bucketCount() && length <= 64; ++length) {
+        if (!store.bucket(length)) continue;
+        GameState state(store, length);
+        book.expand(state, depth, minCandidates);
+    }
+
+    std::sort(book.entries_.begin(), book.entries_.end(),
+              [](const Entry& a, const Entry& b) { return a.key < b.key; });
+    return book;
+}
+
+/**
+ * Records the policy's letter for a state and recurses into every answer.
+ * Each answer is applied to the shared state and undone afterwards, so the
+ * walk never copies a candidate set.
+ * @param state The state to expand; it is left as it was found.
+ * @param turnsLeft Number of turns still to cover.
+ * @param minCandidates Smallest candidate set worth storing a move for.
+ */
+void OpeningBook::expand(GameState& state, int turnsLeft, size_t minCandidates) {
+    const CandidateSet& candidates = state.candidates();
+    if (turnsLeft <= 0 || candidates.count() < minCandidates || state.solved()) return;
+
+    char letter = mostFrequentLetter(candidates.letterCounts(state.guessedLetters()));
+    if (letter == '\0') return;
+    const std::string& pattern = state.pattern();
+    entries_.push_back(Entry{stateKey(pattern, state.guessedLetters()), state.guessedLetters(),
+                             static_cast<uint32_t>(patterns_.size()), static_cast<uint16_t>(pattern.length()), letter, 0});
+    patterns_ += pattern;
+
+    // Every distinct set of positions the letter can occupy is one possible answer
+    std::vector<uint64_t> answers;
+    candidates.forEach([&](std::string_view word) {
+        uint64_t positions = 0;
+        for (size_t i = 0; i < word.length(); ++i) {
+            if (word[i] == letter) positions |= uint64_t{1} << i;
+        }
+        answers.push_back(positions);
+    });
+    std::sort(answers.begin(), answers.end());
+    answers.erase(std::unique(answers.begin(), answers.end()), answers.end());
+
+    for (uint64_t positions : answers) {
+        state.apply(LetterAnswer{letter, positions});
+        expand(state, turnsLeft - 1, minCandidates);
+        state.undo();
+    }
+}
+
+/**
+ * Function to save the opening book.
+ * @param filename The name of the book file (normally next to the dictionary).
+ * @param dictionary The dictionary the book was built from.
+ * @return True if the file was written successfully, false otherwise.
+ */
+bool OpeningBook::save(const std::string& filename, const Dictionary& dictionary) const {
+    // Renamed into place when complete, so a reloading game never reads half a book
+    std::string temporary = filename + ".tmp";
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not write opening book: " << filename << "\n";
+        return false;
+    }
+
+    BookHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kBookMagic, sizeof(kBookMagic));
+    header.version = kBookVersion;
+    header.depth = static_cast<uint32_t>(depth_);
+    header.fingerprint = dictionary.fingerprint();
+    header.entryCount = entries_.size();
+    header.patternBytes = patterns_.size();
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries_.data()), static_cast<std::streamsize>(entries_.size() * sizeof(Entry)));
+    file.write(patterns_.data(), static_cast<std::streamsize>(patterns_.size()));
+    file.close();
+    if (!file || std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Function to load the opening book.
+ * @param filename The name of the book file.
+ * @param dictionary The dictionary the game is using.
+ * @return True if the book was loaded and matches the dictionary, false otherwise.
+ */
+bool OpeningBook::load(const std::string& filename, const Dictionary& dictionary) {
+    entries_.clear();
+    patterns_.clear();
+    depth_ = 0;
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false; // The book is optional
+    }
+
+    BookHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, kBookMagic, sizeof(kBookMagic)) != 0 || header.version != kBookVersion) {
+        std::cerr << "Error: Not a Knowsall opening book (or wrong version): " << filename << "\n";
+        return false;
+    }
+    if (header.fingerprint != dictionary.fingerprint()) {
+        std::cerr << "Note: " << filename << " was built for a different dictionary; ignoring it.\n";
+        return false;
+    }
+
+    // Check the size before allocating so a corrupt count cannot ask for gigabytes
+    std::streamoff start = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff available = file.tellg() - start;
+    file.seekg(start);
+    if (header.entryCount > static_cast<uint64_t>(available) / sizeof(Entry) ||
+        header.patternBytes > static_cast<uint64_t>(available) - header.entryCount * sizeof(Entry)) {
+        std::cerr << "Error: Opening book is truncated: " << filename << "\n";
+        return false;
+    }
+
+    entries_.resize(header.entryCount);
+    patterns_.resize(header.patternBytes);
+    if (!file.read(reinterpret_cast<char*>(entries_.data()), static_cast<std::streamsize>(entries_.size() * sizeof(Entry))) ||
+        !file.read(patterns_.data(), static_cast<std::streamsize>(patterns_.size()))) {
+        std::cerr << "Error: Opening book is truncated: " << filename << "\n";
+        entries_.clear();
+        patterns_.clear();
+        return false;
+    }
+    for (const Entry& entry : entries_) {
+        if (entry.patternOffset > patterns_.size() || entry.length > patterns_.size() - entry.patternOffset) {
+            std::cerr << "Error: Opening book is corrupt: " << filename << "\n";
+            entries_.clear();
+            patterns_.clear();
+            return false;
+        }
+    }
+    depth_ = static_cast<int>(header.depth);
+    return true;
+}
+
+char OpeningBook::lookup(std::string_view guessedWord, uint32_t guessedLetters) const {
+    if (entries_.empty()) return '\0';
+
+    uint64_t key = stateKey(guessedWord, guessedLetters);
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), key,
+                               [](const Entry& entry, uint64_t k) { return entry.key < k; });
+    for (; it != entries_.end() && it->key == key; ++it) {
+        if (it->guessedLetters == guessedLetters && it->length == guessedWord.length() &&
+            guessedWord == std::string_view(patterns_).substr(it->patternOffset, it->length)) {
+            return it->letter;
+        }
+    }
+    return '\0';
+}
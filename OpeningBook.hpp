@@ -0,0 +1,54 @@
+#ifndef OPENING_BOOK_HPP
+#define OPENING_BOOK_HPP
+
+#include "CandidateStore.hpp"
+#include "GameState.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Precomputed first moves of the most-frequent-letter policy.
+ * Early in a game the candidate set is (almost) the whole length bucket, so
+ * the question only depends on the answers so far. The book stores the next
+ * letter for every state reachable in the first few turns, keyed by
+ * (revealed pattern, asked letters), and is saved next to the dictionary.
+ * Entries are found by a hash of the key and keep the key itself, so a
+ * lookup only returns the letter of the very same state.
+ */
+class OpeningBook {
+public:
+    // Builds the book for every length bucket, following every answer the
+    // dictionary can produce for up to depth turns. States with fewer than
+    // minCandidates words are left to live computation, which is cheap there.
+    static OpeningBook build(const CandidateStore& store, int depth, size_t minCandidates);
+
+    bool save(const std::string& filename, const Dictionary& dictionary) const;
+    // Loads a book; fails if it was built for different dictionary contents.
+    bool load(const std::string& filename, const Dictionary& dictionary);
+
+    // Returns the book letter for this state, or '\0' if the book does not cover it.
+    char lookup(std::string_view guessedWord, uint32_t guessedLetters) const;
+
+    size_t size() const { return entries_.size(); }
+    int depth() const { return depth_; }
+
+private:
+    struct Entry {
+        uint64_t key;           // hash of the pattern and the asked letters, for the search
+        uint32_t guessedLetters;
+        uint32_t patternOffset; // the state's pattern in patterns_, compared on lookup so hash collisions never match
+        uint16_t length;
+        char letter;
+        char reserved;
+    };
+
+    void expand(GameState& state, int turnsLeft, size_t minCandidates);
+
+    std::vector<Entry> entries_; // sorted by key
+    std::string patterns_;       // every entry's pattern, back to back
+    int depth_ = 0;
+};
+
+#endif // OPENING_BOOK_HPP
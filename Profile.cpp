@@ -0,0 +1,149 @@
+#include "Profile.hpp"
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace {
+
+// Bumped by operator new, so it must not need construction: a thread's first allocation may
+// come before (or while) its ProfileStats are set up.
+thread_local uint64_t tAllocations = 0;
+
+// Every live thread's totals, plus what exited threads left behind.
+struct ProfileRegistry {
+    std::mutex mutex;
+    std::vector<std::pair<const ProfileStats*, const uint64_t*>> live;
+    ProfileStats retired;
+};
+
+// Never destroyed, so threads exiting during shutdown can still retire their totals.
+ProfileRegistry& registry() {
+    static ProfileRegistry* instance = new ProfileRegistry;
+    return *instance;
+}
+
+struct ThreadProfile {
+    ProfileStats stats;
+
+    ThreadProfile() {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        registry().live.emplace_back(&stats, &tAllocations);
+    }
+    ~ThreadProfile() {
+        ProfileRegistry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        stats.counts[static_cast<size_t>(ProfileCounter::Allocations)] += tAllocations;
+        shared.retired += stats;
+        for (size_t i = 0; i < shared.live.size(); ++i) {
+            if (shared.live[i].first == &stats) {
+                shared.live.erase(shared.live.begin() + i);
+                break;
+            }
+        }
+    }
+};
+
+const char* const kTimerNames[] = {"filter", "frequency", "choose", "io"};
+
+} // namespace
+
+#if KNOWSALL_PROFILE
+// Counts heap allocations per thread; only profile builds replace the global allocator.
+void* operator new(size_t size) {
+    ++tAllocations;
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+#endif
+
+ProfileStats& ProfileStats::operator+=(const ProfileStats& other) {
+    for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+    for (size_t i = 0; i < nanos.size(); ++i) {
+        nanos[i] += other.nanos[i];
+        calls[i] += other.calls[i];
+    }
+    for (size_t i = 0; i < kProfileTurns; ++i) {
+        candidatesAtTurn[i] += other.candidatesAtTurn[i];
+        gamesAtTurn[i] += other.gamesAtTurn[i];
+    }
+    return *this;
+}
+
+ProfileStats ProfileStats::operator-(const ProfileStats& other) const {
+    ProfileStats difference = *this;
+    for (size_t i = 0; i < counts.size(); ++i) difference.counts[i] -= other.counts[i];
+    for (size_t i = 0; i < nanos.size(); ++i) {
+        difference.nanos[i] -= other.nanos[i];
+        difference.calls[i] -= other.calls[i];
+    }
+    for (size_t i = 0; i < kProfileTurns; ++i) {
+        difference.candidatesAtTurn[i] -= other.candidatesAtTurn[i];
+        difference.gamesAtTurn[i] -= other.gamesAtTurn[i];
+    }
+    return difference;
+}
+
+ProfileStats& threadProfile() {
+    thread_local ThreadProfile profile;
+    return profile.stats;
+}
+
+ProfileStats profileSnapshot() {
+    ProfileStats stats = threadProfile();
+    stats.counts[static_cast<size_t>(ProfileCounter::Allocations)] += tAllocations;
+    return stats;
+}
+
+ProfileStats profileTotals() {
+    threadProfile(); // registers this thread, so its allocations are included
+    ProfileRegistry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    ProfileStats total = shared.retired;
+    for (const auto& [stats, allocations] : shared.live) {
+        total += *stats;
+        total.counts[static_cast<size_t>(ProfileCounter::Allocations)] += *allocations;
+    }
+    return total;
+}
+
+/**
+ * Function to print a stats report.
+ * One line per timer (calls, total and mean time), then words scanned,
+ * allocations per question and the mean number of candidates left at each turn.
+ * @param stats The totals to report, e.g. the difference of two snapshots.
+ * @param out Where to print.
+ */
+void printProfile(const ProfileStats& stats, std::ostream& out) {
+    if (!kProfiling) return;
+
+    auto count = [&](ProfileCounter counter) { return stats.counts[static_cast<size_t>(counter)]; };
+    uint64_t questions = count(ProfileCounter::Questions);
+
+    out << std::fixed << std::setprecision(1)
+        << "profile: " << count(ProfileCounter::Games) << " games, " << questions << " questions, "
+        << count(ProfileCounter::Allocations) << " allocations ("
+        << (questions ? static_cast<double>(count(ProfileCounter::Allocations)) / questions : 0.0) << " per question)\n";
+    for (size_t i = 0; i < stats.nanos.size(); ++i) {
+        out << "  " << std::left << std::setw(10) << kTimerNames[i] << std::right
+            << std::setw(12) << stats.calls[i] << " calls" << std::setw(12) << stats.nanos[i] / 1e6 << " ms"
+            << std::setw(12) << (stats.calls[i] ? static_cast<double>(stats.nanos[i]) / stats.calls[i] : 0.0) << " ns/call\n";
+    }
+    out << "  words filtered " << count(ProfileCounter::WordsFiltered)
+        << ", words counted " << count(ProfileCounter::WordsCounted) << "\n";
+    out << "  candidates per turn:";
+    for (size_t turn = 0; turn < kProfileTurns && stats.gamesAtTurn[turn]; ++turn) {
+        out << " " << turn + 1 << (turn + 1 == kProfileTurns ? "+:" : ":")
+            << std::setprecision(0) << static_cast<double>(stats.candidatesAtTurn[turn]) / stats.gamesAtTurn[turn];
+    }
+    out << "\n";
+}
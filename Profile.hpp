@@ -0,0 +1,130 @@
+#ifndef PROFILE_HPP
+#define PROFILE_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * Hot-path instrumentation.
+ * Build with -DKNOWSALL_PROFILE=1 to count where games spend their time:
+ * scoped timers around filtering, letter counting, question choice and I/O,
+ * counters for words scanned, candidates left at each turn and heap
+ * allocations. Every thread keeps its own totals, so workers never contend.
+ * Without the flag the PROFILE_* macros expand to nothing and no counter
+ * exists, so normal builds pay nothing.
+ *
+ * Independently of the flag, KNOWSALL_PROBE marks game start, each question
+ * and game end as USDT probes when <sys/sdt.h> is available. A probe is a
+ * single nop until a tracer attaches, so release builds keep them, e.g.
+ *   perf buildid-cache --add ./knowsall && perf probe sdt_knowsall:question
+ *   perf record -e sdt_knowsall:question -p PID
+ * Define KNOWSALL_NO_PROBES to leave them out.
+ */
+
+#ifndef KNOWSALL_PROFILE
+#define KNOWSALL_PROFILE 0
+#endif
+
+constexpr bool kProfiling = KNOWSALL_PROFILE != 0;
+
+enum class ProfileCounter {
+    Games,
+    Questions,
+    WordsFiltered, // candidates examined while applying answers
+    WordsCounted,  // bucket words covered while counting letters
+    Allocations,   // operator new calls
+    Count
+};
+
+enum class ProfileTimer {
+    Filter,    // GameState::apply
+    Frequency, // letter counting
+    Choose,    // Strategy::nextQuestion, including any letter counting it does
+    IO,        // waiting for answers
+    Count
+};
+
+// Turns tracked individually in the candidates-per-turn breakdown; later turns share the last slot.
+constexpr size_t kProfileTurns = 16;
+
+/**
+ * Counter and timer totals, for one thread or summed over all of them.
+ */
+struct ProfileStats {
+    std::array<uint64_t, static_cast<size_t>(ProfileCounter::Count)> counts{};
+    std::array<uint64_t, static_cast<size_t>(ProfileTimer::Count)> nanos{};
+    std::array<uint64_t, static_cast<size_t>(ProfileTimer::Count)> calls{};
+    std::array<uint64_t, kProfileTurns> candidatesAtTurn{}; // candidates left when each turn's question was chosen
+    std::array<uint64_t, kProfileTurns> gamesAtTurn{};      // games that reached each turn
+
+    ProfileStats& operator+=(const ProfileStats& other);
+    ProfileStats operator-(const ProfileStats& other) const;
+};
+
+// This thread's running totals; the macros below add to them.
+ProfileStats& threadProfile();
+// A copy of this thread's totals, including its allocation count.
+ProfileStats profileSnapshot();
+// Every thread's totals summed, including threads that have exited. Call while workers are idle.
+ProfileStats profileTotals();
+// Prints a stats report (per-timer calls and time, words scanned, allocations and
+// candidates per turn); prints nothing in builds without KNOWSALL_PROFILE.
+void printProfile(const ProfileStats& stats, std::ostream& out);
+
+/**
+ * Adds the time until the end of the enclosing scope to a timer.
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileTimer timer) : timer_(timer), start_(std::chrono::steady_clock::now()) {}
+    ~ProfileScope() {
+        ProfileStats& stats = threadProfile();
+        size_t index = static_cast<size_t>(timer_);
+        stats.nanos[index] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+        ++stats.calls[index];
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileTimer timer_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#if KNOWSALL_PROFILE
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(timer) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(ProfileTimer::timer)
+#define PROFILE_COUNT(counter, n) (threadProfile().counts[static_cast<size_t>(ProfileCounter::counter)] += (n))
+#define PROFILE_TURN(turn, candidates)                                                    \
+    do {                                                                                  \
+        ProfileStats& profileStats = threadProfile();                                     \
+        size_t profileTurn = std::min<size_t>(static_cast<size_t>(turn), kProfileTurns - 1); \
+        profileStats.candidatesAtTurn[profileTurn] += (candidates);                       \
+        ++profileStats.gamesAtTurn[profileTurn];                                          \
+    } while (0)
+#else
+#define PROFILE_SCOPE(timer) ((void)0)
+#define PROFILE_COUNT(counter, n) ((void)0)
+#define PROFILE_TURN(turn, candidates) ((void)0)
+#endif
+
+#if !defined(KNOWSALL_NO_PROBES) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define KNOWSALL_PROBE(name) DTRACE_PROBE(knowsall, name)
+#define KNOWSALL_PROBE1(name, arg) DTRACE_PROBE1(knowsall, name, arg)
+#define KNOWSALL_PROBE2(name, arg1, arg2) DTRACE_PROBE2(knowsall, name, arg1, arg2)
+#endif
+#endif
+#ifndef KNOWSALL_PROBE
+#define KNOWSALL_PROBE(name) ((void)0)
+#define KNOWSALL_PROBE1(name, arg) ((void)0)
+#define KNOWSALL_PROBE2(name, arg1, arg2) ((void)0)
+#endif
+
+#endif // PROFILE_HPP
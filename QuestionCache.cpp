@@ -0,0 +1,195 @@
+#include "QuestionCache.hpp"
+#include "Dictionary.hpp"
+#include "Random.hpp"
+#include <algorithm>
+
+namespace {
+
+// Layout of an entry word: key bits 63..32, candidates 31..8, letter slot + 1 7..3, reference bit 0.
+// The letter field is 0 in an empty way and all ones in a way being written.
+constexpr uint64_t kTagMask = ~uint64_t{0} << 32;
+constexpr int kCountShift = 8;
+constexpr uint64_t kMaxCount = QuestionCache::kMaxCandidates;
+constexpr int kLetterShift = 3;
+constexpr uint64_t kLetterMask = uint64_t{31} << kLetterShift;
+constexpr uint64_t kBusy = kLetterMask;
+constexpr uint64_t kReferenced = 1;
+
+uint64_t pack(uint64_t key, const QuestionCache::Entry& entry) {
+    uint64_t count = std::min<uint64_t>(entry.candidates, kMaxCount);
+    return (key & kTagMask) | (count << kCountShift) | (static_cast<uint64_t>(letterSlot(entry.letter) + 1) << kLetterShift);
+}
+
+int letterOf(uint64_t word) {
+    return static_cast<int>((word & kLetterMask) >> kLetterShift) - 1;
+}
+
+// True if the way holds an entry whose key has the same upper half.
+bool matches(uint64_t word, uint64_t key) {
+    uint64_t letter = word & kLetterMask;
+    return letter != 0 && letter != kBusy && (word & kTagMask) == (key & kTagMask);
+}
+
+// True if the entry is for a state with these candidates and does not ask a letter already asked.
+bool usable(uint64_t word, uint32_t candidates, uint32_t askedLetters) {
+    return ((word >> kCountShift) & kMaxCount) == std::min<uint64_t>(candidates, kMaxCount) &&
+           !(askedLetters & (uint32_t{1} << letterOf(word)));
+}
+
+} // namespace
+
+QuestionCache::QuestionCache(size_t capacity) {
+    size_t sets = 1;
+    while (sets * kWays < capacity) sets <<= 1;
+    sets_.reset(new Set[sets]);
+    hands_.reset(new std::atomic<uint8_t>[sets]);
+    setMask_ = sets - 1;
+    for (size_t i = 0; i < sets; ++i) {
+        for (size_t way = 0; way < kWays; ++way) {
+            sets_[i].ways[way].store(0, std::memory_order_relaxed);
+            sets_[i].keys[way].store(0, std::memory_order_relaxed);
+        }
+        hands_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Function to compute the canonical key of a game state.
+ * FNV-1a over the pattern (which also fixes the length), the asked letters
+ * and the policy, finished with a SplitMix64 step so the low bits that pick
+ * the set are as well mixed as the high bits kept in the entry.
+ * @param policy The letter policy the entry is for.
+ * @param guessedWord The revealed pattern (e.g., "_pp__").
+ * @param guessedLetters The letters asked so far, as a bitmask.
+ * @return The key.
+ */
+uint64_t QuestionCache::key(Policy policy, std::string_view guessedWord, uint32_t guessedLetters) {
+    uint64_t hash = 0xcbf29ce484222325ULL; // FNV-1a
+    for (char c : guessedWord) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    hash ^= guessedLetters | (static_cast<uint64_t>(policy) << 32);
+    hash *= 0x100000001b3ULL;
+    return mixSeed(hash);
+}
+
+/**
+ * Function to find the way holding a key's entry.
+ * Writers store the key before the entry word that publishes it and mark
+ * the way busy first, so a key read between two equal reads of the entry
+ * word (the reference bit aside) is that entry's key.
+ * @param key The state's key.
+ * @param candidates The state's candidate count.
+ * @param askedLetters The letters asked in the state, as a bitmask.
+ * @param word Receives the entry word of the way found.
+ * @return The way, or nullptr if no entry is usable for the state.
+ */
+std::atomic<uint64_t>* QuestionCache::find(uint64_t key, uint32_t candidates, uint32_t askedLetters, uint64_t& word) const {
+    Set& set = sets_[key & setMask_];
+    for (size_t i = 0; i < kWays; ++i) {
+        word = set.ways[i].load(std::memory_order_acquire);
+        if (!matches(word, key)) continue;
+        uint64_t stored = set.keys[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t again = set.ways[i].load(std::memory_order_relaxed);
+        if (stored != key || ((word ^ again) & ~kReferenced)) continue; // another state with the same upper half
+        return usable(word, candidates, askedLetters) ? &set.ways[i] : nullptr;
+    }
+    return nullptr;
+}
+
+bool QuestionCache::lookup(uint64_t key, uint32_t candidates, uint32_t askedLetters, Entry& entry) {
+    uint64_t word;
+    std::atomic<uint64_t>* way = find(key, candidates, askedLetters, word);
+    if (!way) {
+        counters().misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // Only write when the bit is clear, so hot entries do not bounce their cache line between threads
+    if (!(word & kReferenced)) way->fetch_or(kReferenced, std::memory_order_relaxed);
+    entry.letter = static_cast<char>('a' + letterOf(word));
+    entry.candidates = static_cast<uint32_t>((word >> kCountShift) & kMaxCount);
+    counters().hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool QuestionCache::contains(uint64_t key, uint32_t candidates, uint32_t askedLetters) const {
+    uint64_t word;
+    return find(key, candidates, askedLetters, word) != nullptr;
+}
+
+/**
+ * Function to add an entry.
+ * Takes a free way if the set has one; otherwise CLOCK picks the victim.
+ * A dropped entry only costs a later game the work of counting, so an insert
+ * that keeps losing races to other threads is dropped rather than retried.
+ * @param key The state's key.
+ * @param entry The letter chosen in that state and the candidates left.
+ */
+void QuestionCache::insert(uint64_t key, const Entry& entry) {
+    Set& set = sets_[key & setMask_];
+    uint64_t word = pack(key, entry);
+    // The way is busy while its key is replaced; the entry word is published last
+    auto fill = [&](size_t i) {
+        std::atomic_thread_fence(std::memory_order_release);
+        set.keys[i].store(key, std::memory_order_relaxed);
+        set.ways[i].store(word, std::memory_order_release);
+    };
+    for (size_t i = 0; i < kWays; ++i) {
+        uint64_t current = set.ways[i].load(std::memory_order_relaxed);
+        if (current == 0 && set.ways[i].compare_exchange_strong(current, kBusy, std::memory_order_relaxed)) {
+            fill(i);
+            counters().inserts.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (matches(current, key) && set.keys[i].load(std::memory_order_relaxed) == key) return; // another game got here first
+    }
+
+    // Second chance: a referenced entry loses its bit and is passed over; one without it is replaced
+    std::atomic<uint8_t>& hand = hands_[key & setMask_];
+    uint8_t position = hand.load(std::memory_order_relaxed);
+    for (size_t step = 0; step <= 2 * kWays; ++step, ++position) {
+        size_t i = position % kWays;
+        uint64_t current = set.ways[i].load(std::memory_order_relaxed);
+        if (current == kBusy) continue;
+        if (current & kReferenced) {
+            set.ways[i].compare_exchange_strong(current, current & ~kReferenced, std::memory_order_relaxed);
+            continue;
+        }
+        if (set.ways[i].compare_exchange_strong(current, kBusy, std::memory_order_relaxed)) {
+            fill(i);
+            hand.store(static_cast<uint8_t>(position + 1), std::memory_order_relaxed);
+            Counters& stripe = counters();
+            stripe.inserts.fetch_add(1, std::memory_order_relaxed);
+            stripe.evictions.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+QuestionCache::Stats QuestionCache::stats() const {
+    Stats total;
+    for (const Counters& stripe : stripes_) {
+        total.hits += stripe.hits.load(std::memory_order_relaxed);
+        total.misses += stripe.misses.load(std::memory_order_relaxed);
+        total.inserts += stripe.inserts.load(std::memory_order_relaxed);
+        total.evictions += stripe.evictions.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+size_t QuestionCache::size() const {
+    size_t used = 0;
+    for (size_t i = 0; i <= setMask_; ++i) {
+        for (const std::atomic<uint64_t>& way : sets_[i].ways) used += way.load(std::memory_order_relaxed) != 0;
+    }
+    return used;
+}
+
+// This thread's counter stripe; threads are given stripes in turn.
+QuestionCache::Counters& QuestionCache::counters() {
+    static std::atomic<size_t> nextStripe{0};
+    thread_local size_t stripe = nextStripe.fetch_add(1, std::memory_order_relaxed) % kStripes;
+    return stripes_[stripe];
+}
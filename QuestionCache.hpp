@@ -0,0 +1,114 @@
+#ifndef QUESTION_CACHE_HPP
+#define QUESTION_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+/**
+ * Letter questions already chosen, shared by every game on one dictionary.
+ * Many games reach the same state: the same length, the same revealed
+ * pattern and the same wrong letters. For a policy whose question depends on
+ * nothing else, the cache keeps the letter it chose and the candidates left,
+ * so the next game in that state skips counting letters altogether.
+ *
+ * The key is a 64-bit hash of the state, not the state itself. Entries keep
+ * the whole key, and a hit is only used when its candidate count matches the
+ * state's and its letter has not been asked, so results are the same as
+ * without the cache except on a 64-bit hash collision of two states with the
+ * same candidate count.
+ *
+ * The cache has a fixed size and takes no locks. Each entry is two 64-bit
+ * words: the key, and a word holding the key's upper half, the letter, the
+ * candidate count and a reference bit. Entries come in sets of kWays picked
+ * by the key's lower bits. A lookup reads a set's entry words, and the key
+ * of an entry whose upper half matches; an insert claims a way with a
+ * compare-and-swap, writes the key and then publishes the entry word. When a
+ * set is full, the insert evicts by CLOCK (second chance): it sweeps the set
+ * from the set's hand, clearing reference bits, and replaces the first entry
+ * not looked up since its bit was cleared. Hits, misses, inserts and
+ * evictions are counted in per-thread stripes, so threads do not contend on
+ * the counters.
+ */
+class QuestionCache {
+public:
+    // Policies whose choices are kept apart; the same state gets different letters from each.
+    enum class Policy : uint8_t {
+        MostFrequentLetter = 1, // also the opening book and decision tree
+        MaxEntropy = 2
+    };
+
+    struct Entry {
+        char letter = '\0';
+        uint32_t candidates = 0; // exact below 2^24, saturated above
+    };
+
+    // Largest candidate count an entry holds exactly.
+    static constexpr uint32_t kMaxCandidates = (uint32_t{1} << 24) - 1;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t inserts = 0;
+        uint64_t evictions = 0;
+
+        double hitRate() const { return hits + misses ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+        Stats operator-(const Stats& other) const {
+            return Stats{hits - other.hits, misses - other.misses, inserts - other.inserts, evictions - other.evictions};
+        }
+    };
+
+    static constexpr size_t kWays = 8;
+    static constexpr size_t kDefaultCapacity = size_t{1} << 16; // 1 MiB
+
+    // capacity is in entries, rounded up to a power of two sets of kWays.
+    explicit QuestionCache(size_t capacity = kDefaultCapacity);
+
+    QuestionCache(const QuestionCache&) = delete;
+    QuestionCache& operator=(const QuestionCache&) = delete;
+
+    // Hash of a state's canonical form: the policy, the length and revealed pattern, and the letters
+    // asked (given the pattern, the same as the wrong letters). Different states may share a key.
+    static uint64_t key(Policy policy, std::string_view guessedWord, uint32_t guessedLetters);
+
+    // Finds key's entry for a state with this many candidates and these letters asked (a bitmask),
+    // counting the hit or miss and marking the entry as used. An entry for another count, or whose
+    // letter was already asked, is a miss.
+    bool lookup(uint64_t key, uint32_t candidates, uint32_t askedLetters, Entry& entry);
+    // True if lookup would find an entry, without counting or marking anything.
+    bool contains(uint64_t key, uint32_t candidates, uint32_t askedLetters) const;
+    // Adds an entry (letter must not be '\0'); a racing insert of the same key keeps the first one.
+    void insert(uint64_t key, const Entry& entry);
+
+    Stats stats() const;
+    size_t capacity() const { return (setMask_ + 1) * kWays; }
+    // Entries in use; counted by a scan, so not for hot paths.
+    size_t size() const;
+
+private:
+    struct alignas(64) Counters {
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> inserts{0};
+        std::atomic<uint64_t> evictions{0};
+    };
+    static constexpr size_t kStripes = 16;
+
+    struct alignas(64) Set {
+        std::atomic<uint64_t> ways[kWays]; // entry words; 0 is an empty way
+        std::atomic<uint64_t> keys[kWays]; // the full key of each way
+    };
+
+    // The way with key's entry, if it is usable for the state; its entry word goes to word.
+    std::atomic<uint64_t>* find(uint64_t key, uint32_t candidates, uint32_t askedLetters, uint64_t& word) const;
+    Counters& counters();
+
+    std::unique_ptr<Set[]> sets_;
+    std::unique_ptr<std::atomic<uint8_t>[]> hands_; // where each set's next CLOCK sweep starts
+    size_t setMask_;
+    Counters stripes_[kStripes];
+};
+
+#endif // QUESTION_CACHE_HPP
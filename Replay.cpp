@@ -0,0 +1,347 @@
+#include "Replay.hpp"
+#include "DictionarySnapshot.hpp"
+#include "GameIO.hpp"
+#include "GameLog.hpp"
+#include "Random.hpp"
+#include "Strategy.hpp"
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Games per chunk handed to the pool.
+constexpr size_t kChunkGames = 16;
+
+// One game as the log recorded it.
+struct RecordedGame {
+    LogRecord start;
+    std::vector<LogRecord> questions;
+    LogRecord end;
+    bool ended = false;
+};
+
+// One game as the replay played it.
+struct ReplayedGame {
+    const StrategyInfo* mode = nullptr; // nullptr if the game could not be replayed
+    bool truncated = false;             // not replayed because the log cut the secret word off
+    bool won = false;
+    int turns = 0;
+    uint64_t decisionMicros = 0;
+    int divergedAt = 0; // first turn whose question differs from the log; 0 if none did
+    std::string logged;   // the logged and the replayed question at that turn
+    std::string replayed;
+};
+
+std::string fieldText(const char* field, size_t size) {
+    return std::string(field, strnlen(field, size));
+}
+
+// "letter e" or "word apple", for the report.
+std::string describe(const Question& question) {
+    return question.kind == Question::Kind::Letter ? std::string("letter ") + question.letter : "word " + std::string(question.word);
+}
+
+std::string describe(const LogRecord& record) {
+    return (record.kind == 'W' ? "word " : "letter ") + fieldText(record.question, sizeof(record.question));
+}
+
+// True if a word is longer than the log keeps, so its logged text is cut off.
+bool cutOff(std::string_view word) {
+    return word.length() > sizeof(LogRecord::question);
+}
+
+// True if the question is the one the record logged. A word the log cut off never matches.
+bool sameQuestion(const Question& question, const LogRecord& record) {
+    if (question.kind == Question::Kind::Letter) {
+        return record.kind == 'L' && record.question[0] == question.letter && record.question[1] == '\0';
+    }
+    return record.kind == 'W' && !cutOff(question.word) && fieldText(record.question, sizeof(record.question)) == question.word;
+}
+
+/**
+ * Answers a replayed game: with the logged answers while the questions match
+ * the log, truthfully from the secret word once they do not.
+ * Keeps the decision times the engine logs instead of writing them anywhere.
+ */
+class ReplayIO final : public GameIO {
+public:
+    ReplayIO(const RecordedGame& game, std::string_view secretWord) : game_(game), oracle_(secretWord) {}
+
+    std::string ask(const Question& question, int) override {
+        size_t turn = asked_++;
+        if (divergedAt_ == 0) {
+            if (turn < game_.questions.size() && sameQuestion(question, game_.questions[turn])) {
+                const LogRecord& record = game_.questions[turn];
+                return fieldText(record.answer, sizeof(record.answer));
+            }
+            divergedAt_ = static_cast<int>(turn) + 1;
+            logged_ = turn < game_.questions.size() ? describe(game_.questions[turn]) : "the end of the game";
+            replayed_ = describe(question);
+            if (question.kind == Question::Kind::Word && cutOff(question.word)) {
+                replayed_ += " (longer than the log keeps, so it cannot match)";
+            }
+        }
+        return oracle_.ask(question);
+    }
+
+    std::ostream& out() override { return oracle_.out(); }
+
+    void log(LogRecord record) override {
+        if (record.kind == 'L' || record.kind == 'W') decisionMicros_ += record.decisionMicros;
+    }
+
+    // Fills in the outcome once the game is over; a game that ends before the log did diverges there.
+    void finish(ReplayedGame& result) {
+        if (divergedAt_ == 0 && asked_ < game_.questions.size()) {
+            divergedAt_ = static_cast<int>(asked_) + 1;
+            logged_ = describe(game_.questions[asked_]);
+            replayed_ = "the end of the game";
+        }
+        result.turns = static_cast<int>(asked_);
+        result.decisionMicros = decisionMicros_;
+        result.divergedAt = divergedAt_;
+        result.logged = std::move(logged_);
+        result.replayed = std::move(replayed_);
+    }
+
+private:
+    const RecordedGame& game_;
+    OracleIO oracle_;
+    size_t asked_ = 0;
+    uint64_t decisionMicros_ = 0;
+    int divergedAt_ = 0;
+    std::string logged_;
+    std::string replayed_;
+};
+
+/**
+ * Function to collect the games of a log.
+ * Records of concurrent games interleave, so each record joins the open game
+ * with its strategy and game id; a start record opens a game and an end
+ * record closes it. Games without both are left out.
+ * @param incomplete Set to the number of games or stray records left out.
+ */
+std::vector<RecordedGame> collectGames(const std::vector<LogRecord>& records, size_t& incomplete) {
+    std::vector<RecordedGame> games;
+    std::map<std::pair<std::string, uint64_t>, size_t> open; // (strategy, game id) -> index in games
+    incomplete = 0;
+    for (const LogRecord& record : records) {
+        std::pair<std::string, uint64_t> key(fieldText(record.strategy, sizeof(record.strategy)), record.gameId);
+        if (record.kind == 'S') {
+            if (open.count(key)) ++incomplete; // the previous game under this id never ended
+            open[key] = games.size();
+            games.push_back(RecordedGame{record, {}, {}, false});
+            continue;
+        }
+        auto it = open.find(key);
+        if (it == open.end()) {
+            ++incomplete; // e.g., a version 1 log, which has no start records
+            continue;
+        }
+        RecordedGame& game = games[it->second];
+        if (record.kind == 'E') {
+            game.end = record;
+            game.ended = true;
+            open.erase(it);
+        } else {
+            game.questions.push_back(record);
+        }
+    }
+    incomplete += open.size();
+    games.erase(std::remove_if(games.begin(), games.end(), [](const RecordedGame& game) { return !game.ended; }), games.end());
+    return games;
+}
+
+// Log and replay totals of one strategy.
+struct StrategyTotals {
+    size_t games = 0;
+    size_t same = 0;
+    size_t loggedWins = 0;
+    size_t replayedWins = 0;
+    double loggedTurns = 0;
+    double replayedTurns = 0;
+    std::vector<uint64_t> loggedMicros;
+    std::vector<uint64_t> replayedMicros;
+};
+
+double mean(const std::vector<uint64_t>& sample) {
+    double sum = 0;
+    for (uint64_t value : sample) sum += value;
+    return sample.empty() ? 0.0 : sum / sample.size();
+}
+
+// Value at the given percentile of an unsorted sample (the sample is reordered).
+uint64_t percentile(std::vector<uint64_t>& sample, double fraction) {
+    if (sample.empty()) return 0;
+    size_t rank = std::min(sample.size() - 1, static_cast<size_t>(fraction * sample.size()));
+    std::nth_element(sample.begin(), sample.begin() + rank, sample.end());
+    return sample[rank];
+}
+
+// "game 17 (ai-enhanced, apple)"
+std::string gameName(const RecordedGame& game) {
+    return "game " + std::to_string(game.start.gameId) + " (" + fieldText(game.start.strategy, sizeof(game.start.strategy)) +
+           ", " + fieldText(game.start.question, sizeof(game.start.question)) + ")";
+}
+
+} // namespace
+
+/**
+ * Function to replay a game log and report how the replay differs from it.
+ * @param options The log, the dictionary and strategy to replay it on, and how much to list.
+ * @param report The stream to print the comparison on.
+ * @return 0 on success, 1 if the log or dictionary cannot be read or the strategy is unknown.
+ */
+int runReplay(const ReplayOptions& options, std::ostream& report) {
+    std::vector<LogRecord> records;
+    if (!readGameLog(options.logFile, records)) return 1;
+    size_t incomplete = 0;
+    std::vector<RecordedGame> games = collectGames(records, incomplete);
+
+    const StrategyInfo* forced = nullptr;
+    if (!options.strategy.empty()) {
+        forced = findStrategy(options.strategy);
+        if (!forced) {
+            report << "Unknown strategy: " << options.strategy << "\nAvailable strategies:";
+            for (const auto& strategy : strategyRegistry()) report << " " << strategy.name;
+            report << "\n";
+            return 1;
+        }
+    }
+
+    std::shared_ptr<const DictionarySnapshot> snapshot = DictionarySnapshot::load(options.dictionaryFile, 1);
+    if (!snapshot) {
+        std::cerr << "Failed to load the dictionary: " << options.dictionaryFile << "\n";
+        return 1;
+    }
+    const Dictionary& dictionary = snapshot->dictionary();
+    uint64_t fingerprint = dictionary.fingerprint();
+
+    WorkStealingPool pool(options.threads);
+    report << "Replaying " << games.size() << " games from " << options.logFile << " on " << options.dictionaryFile << " with "
+           << pool.size() << " thread(s)" << (forced ? ", every game as " + options.strategy : std::string()) << "\n";
+
+    std::vector<ReplayedGame> replayed(games.size());
+    pool.parallelFor(games.size(), kChunkGames, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            const RecordedGame& game = games[i];
+            const StrategyInfo* mode = forced ? forced : findStrategy(fieldText(game.start.strategy, sizeof(game.start.strategy)));
+            std::string loggedWord = fieldText(game.start.question, sizeof(game.start.question));
+            size_t id = snapshot->index().find(loggedWord);
+            if (!mode) continue;
+            if (id == WordIndex::npos) {
+                // A word that fills the field may be longer than the log kept
+                replayed[i].truncated = loggedWord.length() == sizeof(game.start.question);
+                continue;
+            }
+
+            // The engine logs decision times into the IO; nothing is written to a file
+            StrategyInfo logged = *mode;
+            logged.rules.logAnswers = true;
+            std::string secretWord(dictionary.word(id));
+            ReplayIO io(game, secretWord);
+            seedGameRng(game.start.seed);
+            replayed[i].won = logged.play(logged, secretWord, snapshot->store(), io);
+            replayed[i].mode = mode;
+            io.finish(replayed[i]);
+        }
+    });
+
+    // One line per logged strategy (and the strategy it was replayed as, when they differ)
+    std::map<std::string, StrategyTotals> totals;
+    size_t skipped = 0, truncated = 0, otherDictionary = 0;
+    for (size_t i = 0; i < games.size(); ++i) {
+        const RecordedGame& game = games[i];
+        const ReplayedGame& result = replayed[i];
+        if (!result.mode) {
+            ++(result.truncated ? truncated : skipped);
+            continue;
+        }
+        otherDictionary += game.start.dictionary != fingerprint;
+        std::string name = fieldText(game.start.strategy, sizeof(game.start.strategy));
+        if (name != result.mode->name) name += " -> " + std::string(result.mode->name);
+
+        StrategyTotals& row = totals[name];
+        ++row.games;
+        row.same += result.divergedAt == 0;
+        row.loggedWins += fieldText(game.end.answer, sizeof(game.end.answer)) == "win";
+        row.replayedWins += result.won;
+        row.loggedTurns += game.end.turn;
+        row.replayedTurns += result.turns;
+        uint64_t loggedMicros = 0;
+        for (const LogRecord& question : game.questions) loggedMicros += question.decisionMicros;
+        row.loggedMicros.push_back(loggedMicros);
+        row.replayedMicros.push_back(result.decisionMicros);
+    }
+
+    report << std::left << std::setw(28) << "strategy" << std::right
+           << std::setw(8) << "games" << std::setw(8) << "same %"
+           << std::setw(10) << "win % log" << std::setw(8) << "now"
+           << std::setw(8) << "q log" << std::setw(8) << "now"
+           << std::setw(12) << "decide us" << std::setw(10) << "now"
+           << std::setw(10) << "p99 log" << std::setw(10) << "now" << "\n";
+    for (auto& [name, row] : totals) {
+        double games = row.games ? static_cast<double>(row.games) : 1.0;
+        report << std::left << std::setw(28) << name << std::right << std::fixed
+               << std::setw(8) << row.games
+               << std::setw(8) << std::setprecision(2) << 100.0 * row.same / games
+               << std::setw(10) << std::setprecision(2) << 100.0 * row.loggedWins / games
+               << std::setw(8) << std::setprecision(2) << 100.0 * row.replayedWins / games
+               << std::setw(8) << std::setprecision(2) << row.loggedTurns / games
+               << std::setw(8) << std::setprecision(2) << row.replayedTurns / games
+               << std::setw(12) << std::setprecision(1) << mean(row.loggedMicros)
+               << std::setw(10) << std::setprecision(1) << mean(row.replayedMicros)
+               << std::setw(10) << percentile(row.loggedMicros, 0.99)
+               << std::setw(10) << percentile(row.replayedMicros, 0.99) << "\n";
+    }
+    if (otherDictionary > 0) {
+        report << "Note: " << otherDictionary << " game(s) were logged on a different dictionary.\n";
+    }
+    if (truncated > 0) {
+        report << "Skipped " << truncated << " game(s) whose secret word was truncated in the log (longer than "
+               << sizeof(LogRecord::question) << " characters).\n";
+    }
+    if (skipped > 0 || incomplete > 0) {
+        report << "Skipped " << skipped << " game(s) with an unknown strategy or a word not in the dictionary, and "
+               << incomplete << " game(s) or record(s) without a start or end record.\n";
+    }
+
+    std::vector<size_t> order;
+    for (size_t i = 0; i < games.size() && order.size() < options.show; ++i) {
+        if (replayed[i].mode && replayed[i].divergedAt > 0) order.push_back(i);
+    }
+    if (!order.empty()) report << "First diverging games:\n";
+    for (size_t i : order) {
+        report << "  " << gameName(games[i]) << " at turn " << replayed[i].divergedAt << ": asked " << replayed[i].replayed
+               << ", the log has " << replayed[i].logged << "\n";
+    }
+
+    // Largest changes in decision time per game, either way
+    order.clear();
+    std::vector<int64_t> change(games.size(), 0);
+    for (size_t i = 0; i < games.size(); ++i) {
+        if (!replayed[i].mode) continue;
+        int64_t loggedMicros = 0;
+        for (const LogRecord& question : games[i].questions) loggedMicros += question.decisionMicros;
+        change[i] = static_cast<int64_t>(replayed[i].decisionMicros) - loggedMicros;
+        order.push_back(i);
+    }
+    size_t shown = std::min(options.show, order.size());
+    std::partial_sort(order.begin(), order.begin() + shown, order.end(),
+                      [&](size_t a, size_t b) { return std::llabs(change[a]) > std::llabs(change[b]); });
+    if (shown > 0) report << "Largest decision time changes (us per game):\n";
+    for (size_t k = 0; k < shown; ++k) {
+        size_t i = order[k];
+        report << "  " << gameName(games[i]) << ": " << static_cast<int64_t>(replayed[i].decisionMicros) - change[i] << " -> "
+               << replayed[i].decisionMicros << "\n";
+    }
+    return 0;
+}
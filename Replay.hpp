@@ -0,0 +1,32 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+/**
+ * Options for replaying a game log.
+ */
+struct ReplayOptions {
+    std::string logFile;                           // JSONL or binary game log to replay
+    std::string dictionaryFile = "dictionary.txt"; // dictionary to replay on; its .kdx, .book and .tree are used too
+    std::string strategy;                          // replay every game with this strategy; empty uses the logged one
+    unsigned threads = 0;                          // worker threads; 0 uses one per hardware thread
+    size_t show = 5;                               // games listed under divergences and under timing changes
+};
+
+/**
+ * Replays every complete game of a game log, at full speed and without
+ * anyone answering: each game is played again from its logged secret word
+ * and seed, and the logged answers are fed back for as long as the strategy
+ * asks the logged questions. From the first question that differs the game
+ * diverges and the rest is answered truthfully from the secret word.
+ * Prints one line per strategy comparing the log with the replay (games
+ * with the same questions, win rate, questions, decision time per game),
+ * then the first diverging games and the largest decision time changes.
+ * @return 0 on success, 1 if the log or dictionary cannot be read or the strategy is unknown.
+ */
+int runReplay(const ReplayOptions& options, std::ostream& report);
+
+#endif // REPLAY_HPP
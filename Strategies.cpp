@@ -0,0 +1,332 @@
+#include "Strategies.hpp"
+#include "DecisionTree.hpp"
+#include "EntropyStrategy.hpp"
+#include "GameEngine.hpp"
+#include "OpeningBook.hpp"
+#include "QuestionCache.hpp"
+#include "Random.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// The few candidates left in an endgame, with where each letter sits in each of them.
+struct Endgame {
+    size_t count = 0;
+    std::string_view words[HybridStrategy::kEndgameCandidates];
+    uint64_t positions[HybridStrategy::kEndgameCandidates][kAlphabetSize];
+    uint32_t letters[HybridStrategy::kEndgameCandidates]; // letters each word contains
+};
+
+// Questions still needed for n candidates: guessing words one by one takes
+// (n + 1) / 2 on average, letters about 1 + log2(n).
+double remainingCost(size_t n) {
+    if (n <= 1) return static_cast<double>(n);
+    return std::min((n + 1) / 2.0, 1.0 + std::log2(static_cast<double>(n)));
+}
+
+/**
+ * Function to find the letter expected to finish an endgame soonest.
+ * Each letter that splits the candidates is scored by one question plus, for
+ * each answer it can get, that answer's likelihood times the questions still
+ * needed afterwards (none if the answer reveals the whole word).
+ * @param game The endgame's words.
+ * @param guessed Letters asked so far.
+ * @param bestLetter Receives the best letter, or '\0' if no letter splits the candidates.
+ * @return Expected questions to finish after asking the best letter.
+ */
+double bestLetterCost(const Endgame& game, uint32_t guessed, char& bestLetter) {
+    size_t n = game.count;
+    double bestCost = INFINITY;
+    bestLetter = '\0';
+
+    uint32_t present = 0;
+    for (size_t i = 0; i < n; ++i) present |= game.letters[i];
+    present &= ~guessed;
+    while (present) {
+        int letter = __builtin_ctz(present);
+        present &= present - 1;
+        uint32_t asked = guessed | (uint32_t{1} << letter);
+
+        // Group the candidates by the answer this letter would get
+        uint8_t order[HybridStrategy::kEndgameCandidates] = {};
+        for (size_t i = 0; i < n; ++i) order[i] = static_cast<uint8_t>(i);
+        std::sort(order, order + n, [&](uint8_t a, uint8_t b) {
+            return game.positions[a][letter] < game.positions[b][letter];
+        });
+        if (game.positions[order[0]][letter] == game.positions[order[n - 1]][letter]) continue; // no split
+
+        double cost = 1.0;
+        for (size_t begin = 0; begin < n;) {
+            size_t end = begin + 1;
+            while (end < n && game.positions[order[end]][letter] == game.positions[order[begin]][letter]) ++end;
+            size_t size = end - begin;
+            // A lone word is either fully revealed by now or one word guess away
+            double groupCost = size > 1 ? remainingCost(size) : (game.letters[order[begin]] & ~asked) == 0 ? 0.0 : 1.0;
+            cost += static_cast<double>(size) / n * groupCost;
+            begin = end;
+        }
+        if (cost < bestCost) {
+            bestCost = cost;
+            bestLetter = static_cast<char>('a' + letter);
+        }
+    }
+    return bestCost;
+}
+
+// The state's candidate count as a cache entry holds it.
+uint32_t cachedCount(const GameState& state) {
+    return static_cast<uint32_t>(std::min<size_t>(state.candidates().count(), QuestionCache::kMaxCandidates));
+}
+
+/**
+ * Function to take a policy's letter from the store's question cache, or to
+ * choose it and cache it. Only for policies whose letter depends on nothing
+ * but the game state. The cache checks a hit against the state's candidate
+ * count and asked letters, so an entry from another state with the same
+ * key is not used.
+ * @param policy The policy choose implements.
+ * @param state The current game state.
+ * @param choose Computes the letter when the cache does not have it.
+ * @return The letter, or '\0' if there is none to ask.
+ */
+template <typename Choose>
+char cachedLetter(const CandidateStore& store, QuestionCache::Policy policy, const GameState& state, Choose choose) {
+    QuestionCache* cache = store.questionCache();
+    if (!cache) return choose();
+    uint64_t key = QuestionCache::key(policy, state.pattern(), state.guessedLetters());
+    uint32_t candidates = cachedCount(state);
+    QuestionCache::Entry entry;
+    if (cache->lookup(key, candidates, state.guessedLetters(), entry)) return entry.letter;
+    char letter = choose();
+    if (letter != '\0') cache->insert(key, QuestionCache::Entry{letter, candidates});
+    return letter;
+}
+
+// True if the question cache has the policy's letter for this state, so nothing needs counting.
+bool isCached(const CandidateStore& store, QuestionCache::Policy policy, const GameState& state) {
+    const QuestionCache* cache = store.questionCache();
+    return cache && cache->contains(QuestionCache::key(policy, state.pattern(), state.guessedLetters()), cachedCount(state),
+                                    state.guessedLetters());
+}
+
+} // namespace
+
+Question SequentialLetterStrategy::nextQuestion(const GameState&) {
+    return Question::aboutLetter(static_cast<char>('a' + (answered_ % 26))); // Sequential guessing
+}
+
+void SequentialLetterStrategy::observe(const Answer&) {
+    ++answered_;
+}
+
+Question LetterOrderStrategy::nextQuestion(const GameState&) {
+    if (next_ == order_.size()) return Question::aboutLetter('\0');
+    return Question::aboutLetter(order_[next_++]);
+}
+
+ShuffledLetterStrategy::ShuffledLetterStrategy(const CandidateStore&, size_t) : LetterOrderStrategy("abcdefghijklmnopqrstuvwxyz") {
+    std::shuffle(order_.begin(), order_.end(), gameRng());
+}
+
+/**
+ * Picks a random order of the dictionary words, keyed from the game's random engine.
+ * @param store The dictionary index.
+ */
+ShuffledWordStrategy::ShuffledWordStrategy(const CandidateStore& store, size_t)
+    : dictionary_(store.dictionary()), order_(dictionary_.size(), gameRng()()) {}
+
+Question DictionaryOrderStrategy::nextQuestion(const GameState&) {
+    if (next_ == dictionary_.size()) return Question::aboutWord({});
+    return Question::aboutWord(dictionary_.word(next_++));
+}
+
+Question ShuffledWordStrategy::nextQuestion(const GameState&) {
+    if (next_ == order_.size()) return Question::aboutWord({});
+    return Question::aboutWord(dictionary_.word(order_[next_++]));
+}
+
+Question MostFrequentLetterStrategy::nextQuestion(const GameState& state) {
+    const CandidateSet& candidates = state.candidates();
+    if (candidates.empty()) return Question::aboutLetter('\0');
+    return Question::aboutLetter(cachedLetter(store_, QuestionCache::Policy::MostFrequentLetter, state,
+                                              [&]() { return mostFrequentLetter(state.letterCounts()); }));
+}
+
+bool MostFrequentLetterStrategy::needsLetterCounts(const GameState& state) const {
+    return !state.candidates().empty() && !isCached(store_, QuestionCache::Policy::MostFrequentLetter, state);
+}
+
+Question OpeningBookStrategy::nextQuestion(const GameState& state) {
+    // A compiled tree answers every state of its lengths by walking the answers
+    const DecisionTree* tree = store_.decisionTree();
+    char letter = '\0';
+    if (tree && tree->lookup(state.pattern(), state.guessedLetters(), letter)) {
+        return Question::aboutLetter(letter);
+    }
+
+    const CandidateSet& candidates = state.candidates();
+    if (candidates.empty()) return Question::aboutLetter('\0');
+
+    // Early turns come from the opening book when it covers this state
+    const OpeningBook* book = store_.openingBook();
+    letter = book ? book->lookup(state.pattern(), state.guessedLetters()) : '\0';
+    if (letter == '\0') {
+        letter = cachedLetter(store_, QuestionCache::Policy::MostFrequentLetter, state,
+                              [&]() { return mostFrequentLetter(state.letterCounts()); });
+    }
+    return Question::aboutLetter(letter);
+}
+
+// Counts are only needed where neither the tree, the opening book nor the question cache has the move.
+bool OpeningBookStrategy::needsLetterCounts(const GameState& state) const {
+    char letter;
+    const DecisionTree* tree = store_.decisionTree();
+    if (tree && tree->lookup(state.pattern(), state.guessedLetters(), letter)) return false;
+    if (state.candidates().empty()) return false;
+    const OpeningBook* book = store_.openingBook();
+    if (book && book->lookup(state.pattern(), state.guessedLetters()) != '\0') return false;
+    return !isCached(store_, QuestionCache::Policy::MostFrequentLetter, state);
+}
+
+/**
+ * Picks a letter or a word guess.
+ * While more than kEndgameCandidates words remain, letters come from the
+ * opening book policy. Below that, the expected number of questions to finish
+ * is estimated for guessing a word and for every letter (one answer ahead),
+ * and the word is guessed whenever that is cheaper.
+ * @param state The current game state.
+ * @return The question to ask.
+ */
+Question HybridStrategy::nextQuestion(const GameState& state) {
+    const CandidateSet& candidates = state.candidates();
+    size_t count = candidates.count();
+    if (count == 0) return Question::aboutLetter('\0');
+    if (count > kEndgameCandidates + rejected_.size()) return letters_.nextQuestion(state);
+
+    Endgame game;
+    size_t remaining = 0;
+    candidates.forEach([&](std::string_view word) {
+        if (std::find(rejected_.begin(), rejected_.end(), word) != rejected_.end()) return;
+        if (++remaining > kEndgameCandidates) return;
+        size_t index = game.count++;
+        game.words[index] = word;
+        game.letters[index] = 0;
+        std::fill(std::begin(game.positions[index]), std::end(game.positions[index]), 0);
+        for (size_t i = 0; i < word.length() && i < 64; ++i) {
+            int slot = letterSlot(word[i]);
+            if (slot == kAlphabetSize) continue;
+            game.positions[index][slot] |= uint64_t{1} << i;
+            game.letters[index] |= uint32_t{1} << slot;
+        }
+    });
+    if (remaining == 0) return Question::aboutWord({});
+    if (remaining > kEndgameCandidates) return letters_.nextQuestion(state);
+
+    // A word guess is right with probability 1/n; if wrong, n - 1 candidates are left
+    double wordCost = 1.0 + (game.count - 1.0) / game.count * remainingCost(game.count - 1);
+    char letter;
+    double letterCost = bestLetterCost(game, state.guessedLetters(), letter);
+    if (letter == '\0' || wordCost < letterCost) return Question::aboutWord(game.words[0]);
+    return Question::aboutLetter(letter);
+}
+
+void HybridStrategy::observe(const Answer& answer) {
+    if (answer.question.kind == Question::Kind::Word && !answer.yes) rejected_.push_back(answer.question.word);
+}
+
+Question MaxEntropyStrategy::nextQuestion(const GameState& state) {
+    const CandidateSet& candidates = state.candidates();
+    if (candidates.empty()) return Question::aboutLetter('\0');
+    return Question::aboutLetter(cachedLetter(store_, QuestionCache::Policy::MaxEntropy, state,
+                                              [&]() { return chooseMaxEntropyLetter(candidates, state.guessedLetters()); }));
+}
+
+namespace {
+
+template <typename S>
+StrategyInfo builtIn(const char* name, const char* title, int menuChoice, const GameRules& rules) {
+    return StrategyInfo{name, title, menuChoice, rules, &playWith<S, GameIO>, &playWith<S, OracleIO>, &makeStrategy<S>};
+}
+
+GameRules rules(const char* intro) {
+    GameRules rules;
+    rules.intro = intro;
+    return rules;
+}
+
+std::vector<StrategyInfo> builtInStrategies() {
+    GameRules enhanced = rules("\nKnowsall will guess your word using AI-like features.\n");
+    enhanced.timeLimitSeconds = 10; // 10-second timer for user response
+    enhanced.showBoard = true;
+    enhanced.logAnswers = true;
+    enhanced.allowUndo = true;
+    enhanced.lockstep = true;
+
+    GameRules challenging = rules("\nKnowsall will guess your word in Challenging Mode!\n");
+    challenging.maxQuestions = 10; // Reduced number of guesses
+    challenging.timeLimitSeconds = 5;
+    challenging.missPenalty = 2;   // Penalty for incorrect guesses
+    challenging.showBoard = true;
+    challenging.lockstep = true;
+
+    GameRules ai = rules("\nKnowsall will guess your word using AI-like features.\n");
+    ai.lockstep = true;
+
+    GameRules entropy = rules("\nKnowsall will guess your word by maximizing the information of each question.\n");
+    entropy.showBoard = true;
+
+    GameRules hybrid = rules("\nKnowsall will guess letters, then whole words once few candidates are left.\n");
+    hybrid.showBoard = true;
+
+    // Batch seeds depend on the position in this list, so new modes go at the end
+    return {
+        builtIn<ShuffledLetterStrategy>("randomized-letters", "Randomized Letter-by-Letter Guessing", 1,
+                                        rules("\nKnowsall will guess your word letter by letter in random order.\n")),
+        builtIn<ShuffledWordStrategy>("randomized-words", "Randomized Word-by-Word Guessing", 2,
+                                      rules("\nKnowsall will guess your word word by word in random order.\n")),
+        builtIn<EnglishFrequencyStrategy>("frequency", "Frequency-Based Guessing", 3,
+                                          rules("\nKnowsall will guess your word based on letter frequency.\n")),
+        builtIn<RandomWordStrategy>("random-word", "Random Word Guessing", 4,
+                                    rules("\nKnowsall will guess random words from the dictionary.\n")),
+        builtIn<OpeningBookStrategy>("ai-enhanced", "AI Guessing with Enhancements", 5, enhanced),
+        builtIn<OpeningBookStrategy>("challenging", "Challenging Mode", 6, challenging),
+        builtIn<MaxEntropyStrategy>("entropy", "Entropy-Based Guessing", 7, entropy),
+        builtIn<SequentialLetterStrategy>("letters", "Letter-by-Letter Guessing", 0,
+                                          rules("\nKnowsall will guess your word letter by letter.\n")),
+        builtIn<DictionaryOrderStrategy>("words", "Word-by-Word Guessing", 0,
+                                         rules("\nKnowsall will guess your word word by word.\n")),
+        builtIn<MostFrequentLetterStrategy>("ai", "AI Guessing", 0, ai),
+        builtIn<HybridStrategy>("hybrid", "Hybrid Letter and Word Guessing", 8, hybrid),
+    };
+}
+
+std::vector<StrategyInfo>& registry() {
+    static std::vector<StrategyInfo> strategies = builtInStrategies();
+    return strategies;
+}
+
+} // namespace
+
+const std::vector<StrategyInfo>& strategyRegistry() {
+    return registry();
+}
+
+/**
+ * Function to add a game mode to the registry.
+ * Register modes before any game starts; the registry is not locked.
+ * @param info The mode to add.
+ * @return True if it was added, false if the name is already taken.
+ */
+bool registerStrategy(const StrategyInfo& info) {
+    if (findStrategy(info.name)) return false;
+    registry().push_back(info);
+    return true;
+}
+
+const StrategyInfo* findStrategy(const std::string& name) {
+    for (const StrategyInfo& info : registry()) {
+        if (name == info.name) return &info;
+    }
+    return nullptr;
+}
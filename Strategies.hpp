@@ -0,0 +1,130 @@
+#ifndef STRATEGIES_HPP
+#define STRATEGIES_HPP
+
+#include "Random.hpp"
+#include "Strategy.hpp"
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * The built-in strategies. Each takes (store, secret word length).
+ */
+
+// Asks 'a', 'b', 'c', ... in order.
+class SequentialLetterStrategy final : public Strategy {
+public:
+    SequentialLetterStrategy(const CandidateStore&, size_t) {}
+    Question nextQuestion(const GameState& state) override;
+    void observe(const Answer& answer) override;
+
+private:
+    int answered_ = 0;
+};
+
+// Asks letters in a fixed order, skipping none; subclasses choose the order.
+class LetterOrderStrategy : public Strategy {
+public:
+    Question nextQuestion(const GameState& state) override;
+
+protected:
+    // order holds every letter once; kept inline so building the strategy never allocates
+    explicit LetterOrderStrategy(std::string_view order) { order.copy(order_.data(), order_.size()); }
+
+    std::array<char, kAlphabetSize> order_{};
+
+private:
+    size_t next_ = 0;
+};
+
+// Asks the alphabet in a random order.
+class ShuffledLetterStrategy final : public LetterOrderStrategy {
+public:
+    ShuffledLetterStrategy(const CandidateStore& store, size_t length);
+};
+
+// Asks letters from the most to the least common in English text.
+class EnglishFrequencyStrategy final : public LetterOrderStrategy {
+public:
+    EnglishFrequencyStrategy(const CandidateStore&, size_t) : LetterOrderStrategy("etaoinshrdlcumwfgypbvkjxqz") {}
+};
+
+// Guesses every dictionary word in dictionary order.
+class DictionaryOrderStrategy final : public Strategy {
+public:
+    DictionaryOrderStrategy(const CandidateStore& store, size_t) : dictionary_(store.dictionary()) {}
+    Question nextQuestion(const GameState& state) override;
+
+private:
+    const Dictionary& dictionary_;
+    size_t next_ = 0;
+};
+
+// Guesses every dictionary word once, in a random order.
+class ShuffledWordStrategy final : public Strategy {
+public:
+    ShuffledWordStrategy(const CandidateStore& store, size_t length);
+    Question nextQuestion(const GameState& state) override;
+
+private:
+    const Dictionary& dictionary_;
+    RandomPermutation order_; // computed per question, so no game copies the word list
+    size_t next_ = 0;
+};
+
+// Guesses a random dictionary word each turn. It used to draw with repeats; without
+// them, a random word each turn is exactly a random order of the words.
+using RandomWordStrategy = ShuffledWordStrategy;
+
+// Asks the letter most of the remaining candidates contain.
+class MostFrequentLetterStrategy final : public Strategy {
+public:
+    MostFrequentLetterStrategy(const CandidateStore& store, size_t) : store_(store) {}
+    Question nextQuestion(const GameState& state) override;
+    bool needsLetterCounts(const GameState& state) const override;
+
+private:
+    const CandidateStore& store_;
+};
+
+// As MostFrequentLetterStrategy, but walks the compiled decision tree when there is one
+// and otherwise takes early turns from the opening book.
+class OpeningBookStrategy final : public Strategy {
+public:
+    OpeningBookStrategy(const CandidateStore& store, size_t) : store_(store) {}
+    Question nextQuestion(const GameState& state) override;
+    bool needsLetterCounts(const GameState& state) const override;
+
+private:
+    const CandidateStore& store_;
+};
+
+// Asks the letter whose answer is expected to split the candidates most evenly.
+class MaxEntropyStrategy final : public Strategy {
+public:
+    MaxEntropyStrategy(const CandidateStore& store, size_t) : store_(store) {}
+    Question nextQuestion(const GameState& state) override;
+
+private:
+    const CandidateStore& store_;
+};
+
+// Asks letters like OpeningBookStrategy while many candidates remain, then guesses
+// whole words once that is expected to take fewer questions than another letter.
+class HybridStrategy final : public Strategy {
+public:
+    HybridStrategy(const CandidateStore& store, size_t length) : letters_(store, length) { rejected_.reserve(kEndgameCandidates); }
+    Question nextQuestion(const GameState& state) override;
+    void observe(const Answer& answer) override;
+    bool needsLetterCounts(const GameState& state) const override { return letters_.needsLetterCounts(state); }
+
+    // Candidates at or below which words are weighed against letters.
+    static constexpr size_t kEndgameCandidates = 16;
+
+private:
+    OpeningBookStrategy letters_;
+    std::vector<std::string_view> rejected_; // words guessed wrong; still in the candidate set
+};
+
+#endif // STRATEGIES_HPP
@@ -0,0 +1,84 @@
+#ifndef STRATEGY_HPP
+#define STRATEGY_HPP
+
+#include "CandidateStore.hpp"
+#include "GameIO.hpp"
+#include "GameState.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * What the player said about one question.
+ */
+struct Answer {
+    Question question;
+    bool yes = false;
+    uint64_t positions = 0; // for letters: bit i set if the letter is at position i
+};
+
+/**
+ * A way of choosing Knowsall's questions.
+ * The engine owns the game (asking, reveal, question budget, messages) and
+ * keeps the GameState up to date; a strategy only picks the next question
+ * from it and may watch the answers. A strategy is built for one game with
+ * (store, length of the secret word).
+ *
+ * Concrete strategies are final, so the engine instantiated for one of them
+ * calls it directly; the virtual interface is only used when a strategy is
+ * picked at run time through a Strategy&.
+ */
+class Strategy {
+public:
+    virtual ~Strategy() = default;
+
+    // The next question, or an empty() question when there is nothing left to ask.
+    virtual Question nextQuestion(const GameState& state) = 0;
+    // Called after every valid answer, once the state has been updated.
+    virtual void observe(const Answer&) {}
+    // True if nextQuestion(state) will read state.letterCounts(), so a driver
+    // advancing many games can compute the counts for all of them in one pass.
+    virtual bool needsLetterCounts(const GameState&) const { return false; }
+};
+
+/**
+ * How one game mode is played on top of its strategy.
+ */
+struct GameRules {
+    const char* intro = "";    // printed before the first question
+    int maxQuestions = 20;
+    int timeLimitSeconds = 0;  // per answer; 0 waits forever
+    int missPenalty = 0;       // extra questions a "no" costs
+    bool showBoard = false;    // draw the spaced-out board instead of "Updated word:"
+    bool logAnswers = false;   // append every question and answer to the game log
+    bool allowUndo = false;    // accept 'undo'; only for strategies that keep no state of their own
+    bool lockstep = false;     // questions depend only on the GameState (no randomness), so batch runs
+                               // may advance many games together and share their letter counts
+};
+
+/**
+ * A registered game mode: a strategy plus the rules it is played under.
+ * play and playHeadless are the engine instantiated for the concrete strategy;
+ * create builds the strategy on its own for callers that drive the game themselves.
+ */
+struct StrategyInfo {
+    const char* name;   // used by --strategy
+    const char* title;  // shown in the menu
+    int menuChoice;     // menu number; 0 keeps it out of the menu
+    GameRules rules;
+    bool (*play)(const StrategyInfo& info, const std::string& secretWord, const CandidateStore& store, GameIO& io);
+    bool (*playHeadless)(const StrategyInfo& info, const std::string& secretWord, const CandidateStore& store, OracleIO& io);
+    std::unique_ptr<Strategy> (*create)(const CandidateStore& store, size_t length);
+};
+
+// Every registered mode, built-in ones first in their historical batch order.
+const std::vector<StrategyInfo>& strategyRegistry();
+
+// Adds a mode to the registry. Names must be unique; returns false otherwise.
+bool registerStrategy(const StrategyInfo& info);
+
+// The mode with this name, or nullptr.
+const StrategyInfo* findStrategy(const std::string& name);
+
+#endif // STRATEGY_HPP
@@ -0,0 +1,118 @@
+#include "WordIndex.hpp"
+#include <algorithm>
+
+namespace {
+
+char fold(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// FNV-1a over the case-folded word.
+uint64_t foldedHash(std::string_view word) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c : word) {
+        hash ^= static_cast<unsigned char>(fold(c));
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool equalFolded(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (fold(a[i]) != fold(b[i])) return false;
+    }
+    return true;
+}
+
+// Orders by case-folded spelling, then by exact spelling so the order is total.
+bool lessFolded(std::string_view a, std::string_view b) {
+    size_t common = std::min(a.size(), b.size());
+    for (size_t i = 0; i < common; ++i) {
+        char x = fold(a[i]), y = fold(b[i]);
+        if (x != y) return static_cast<unsigned char>(x) < static_cast<unsigned char>(y);
+    }
+    if (a.size() != b.size()) return a.size() < b.size();
+    return a < b;
+}
+
+// Compares the first prefix.size() characters of word with prefix, ignoring case.
+int comparePrefix(std::string_view word, std::string_view prefix) {
+    for (size_t i = 0; i < prefix.size(); ++i) {
+        if (i == word.size()) return -1;
+        unsigned char x = static_cast<unsigned char>(fold(word[i]));
+        unsigned char y = static_cast<unsigned char>(fold(prefix[i]));
+        if (x != y) return x < y ? -1 : 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+/**
+ * Builds the hash table, sized to at most half full.
+ * @param dictionary The loaded dictionary.
+ */
+WordIndex::WordIndex(const Dictionary& dictionary) : dictionary_(dictionary) {
+    size_t size = 16;
+    while (size < dictionary.size() * 2) size <<= 1;
+    slots_.assign(size, 0);
+    mask_ = size - 1;
+
+    for (size_t id = 0; id < dictionary.size(); ++id) {
+        uint64_t hash = foldedHash(dictionary.word(id));
+        size_t slot = hash & mask_;
+        while (slots_[slot] != 0) slot = (slot + 1) & mask_;
+        slots_[slot] = (hash & 0xffffffff00000000ULL) | (id + 1);
+    }
+}
+
+/**
+ * Function to look a word up.
+ * Every spelling of a word shares one probe sequence, so the case-insensitive
+ * lookup walks the same slots as the exact one.
+ * @param word The word to look up.
+ * @param ignoreCase Whether "Apple" may match "apple".
+ * @return The word's id, or npos if it is not in the dictionary.
+ */
+size_t WordIndex::find(std::string_view word, bool ignoreCase) const {
+    uint64_t hash = foldedHash(word);
+    size_t fallback = npos;
+    for (size_t slot = hash & mask_; slots_[slot] != 0; slot = (slot + 1) & mask_) {
+        uint64_t entry = slots_[slot];
+        if ((entry ^ hash) >> 32) continue;
+        size_t id = static_cast<size_t>(entry & 0xffffffffULL) - 1;
+        std::string_view candidate = dictionary_.word(id);
+        if (candidate == word) return id;
+        if (ignoreCase && fallback == npos && equalFolded(candidate, word)) fallback = id;
+    }
+    return fallback;
+}
+
+void WordIndex::buildSorted() const {
+    sorted_.resize(dictionary_.size());
+    for (size_t id = 0; id < sorted_.size(); ++id) sorted_[id] = static_cast<uint32_t>(id);
+    std::sort(sorted_.begin(), sorted_.end(), [this](uint32_t a, uint32_t b) {
+        return lessFolded(dictionary_.word(a), dictionary_.word(b));
+    });
+}
+
+/**
+ * Function to list the words starting with a prefix.
+ * Two binary searches over the sorted ids find the range; the first call sorts them.
+ * @param prefix The prefix, matched ignoring case.
+ * @param limit Most ids to return.
+ * @return The ids, in alphabetical order.
+ */
+std::vector<size_t> WordIndex::withPrefix(std::string_view prefix, size_t limit) const {
+    std::call_once(sortedOnce_, [this]() { buildSorted(); });
+
+    auto first = std::lower_bound(sorted_.begin(), sorted_.end(), prefix, [this](uint32_t id, std::string_view p) {
+        return comparePrefix(dictionary_.word(id), p) < 0;
+    });
+    std::vector<size_t> ids;
+    for (auto it = first; it != sorted_.end() && ids.size() < limit && comparePrefix(dictionary_.word(*it), prefix) == 0; ++it) {
+        ids.push_back(*it);
+    }
+    return ids;
+}
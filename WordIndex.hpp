@@ -0,0 +1,43 @@
+#ifndef WORD_INDEX_HPP
+#define WORD_INDEX_HPP
+
+#include "Dictionary.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+/**
+ * Lookup structures over a loaded dictionary.
+ * Membership is an open-addressing hash table of word ids keyed by the
+ * case-folded word, so exact and case-insensitive lookups both cost one
+ * probe sequence regardless of the dictionary size. Prefix queries use the
+ * word ids sorted by case-folded spelling, built on first use so that
+ * mapping a compiled index stays instant. The dictionary must outlive the index.
+ */
+class WordIndex {
+public:
+    static constexpr size_t npos = SIZE_MAX;
+
+    explicit WordIndex(const Dictionary& dictionary);
+
+    // Id of the word, or npos. With ignoreCase, an exact match wins over other spellings.
+    size_t find(std::string_view word, bool ignoreCase = false) const;
+    bool contains(std::string_view word, bool ignoreCase = false) const { return find(word, ignoreCase) != npos; }
+
+    // Ids of up to limit words starting with prefix (ignoring case), in alphabetical order.
+    std::vector<size_t> withPrefix(std::string_view prefix, size_t limit = npos) const;
+
+private:
+    void buildSorted() const;
+
+    const Dictionary& dictionary_;
+    std::vector<uint64_t> slots_; // (folded hash high 32 bits) << 32 | (id + 1); 0 is empty
+    size_t mask_ = 0;
+
+    mutable std::once_flag sortedOnce_;
+    mutable std::vector<uint32_t> sorted_; // ids by case-folded spelling
+};
+
+#endif // WORD_INDEX_HPP
@@ -0,0 +1,66 @@
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <thread>
+
+/**
+ * Creates the pool.
+ * @param threads Number of workers; 0 uses one per hardware thread.
+ */
+WorkStealingPool::WorkStealingPool(unsigned threads) : threads_(threads) {
+    if (threads_ == 0) {
+        threads_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threads_; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+}
+
+void WorkStealingPool::parallelFor(size_t count, size_t grain, const RangeFn& fn) {
+    grain = std::max<size_t>(1, grain);
+
+    // Deal the chunks out round-robin before any worker starts
+    unsigned next = 0;
+    for (size_t begin = 0; begin < count; begin += grain) {
+        queues_[next]->chunks.emplace_back(begin, std::min(count, begin + grain));
+        next = (next + 1) % threads_;
+    }
+
+    std::vector<std::thread> workers;
+    for (unsigned worker = 1; worker < threads_; ++worker) {
+        workers.emplace_back([this, worker, &fn] { work(worker, fn); });
+    }
+    work(0, fn);
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+bool WorkStealingPool::popOwn(unsigned worker, std::pair<size_t, size_t>& chunk) {
+    Queue& queue = *queues_[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.chunks.empty()) return false;
+    chunk = queue.chunks.back();
+    queue.chunks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned thief, std::pair<size_t, size_t>& chunk) {
+    for (unsigned offset = 1; offset < threads_; ++offset) {
+        Queue& victim = *queues_[(thief + offset) % threads_];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.chunks.empty()) {
+            chunk = victim.chunks.front();
+            victim.chunks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::work(unsigned worker, const RangeFn& fn) {
+    // No chunks are added once the loop starts, so an empty sweep means we are done
+    std::pair<size_t, size_t> chunk;
+    while (popOwn(worker, chunk) || steal(worker, chunk)) {
+        fn(chunk.first, chunk.second, worker);
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * Fixed-size thread pool for data-parallel loops.
+ * A loop is cut into chunks that are dealt round-robin onto per-worker
+ * deques; each worker drains its own deque from the back and, once empty,
+ * steals from the front of the others, so uneven chunks still balance out.
+ */
+class WorkStealingPool {
+public:
+    // Runs fn(begin, end, worker) over [0, count) in chunks of at most grain items.
+    using RangeFn = std::function<void(size_t begin, size_t end, unsigned worker)>;
+
+    explicit WorkStealingPool(unsigned threads = 0);
+
+    unsigned size() const { return threads_; }
+
+    // Blocks until every chunk has run. Worker 0 is the calling thread.
+    void parallelFor(size_t count, size_t grain, const RangeFn& fn);
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::pair<size_t, size_t>> chunks;
+    };
+
+    bool popOwn(unsigned worker, std::pair<size_t, size_t>& chunk);
+    bool steal(unsigned thief, std::pair<size_t, size_t>& chunk);
+    void work(unsigned worker, const RangeFn& fn);
+
+    unsigned threads_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+};
+
+#endif // WORK_STEALING_POOL_HPP